@@ -0,0 +1,915 @@
+#include "bid128.h"
+#include "divide_pow10.h"
+#include <string.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+enum {
+  BID_EXP_BIAS = 6176,
+  BID_EXP_MAX  = 12287, // maximal biased exponent
+  BID_PMAX     = 34,    // precision, decimal digits
+};
+
+enum {
+  BID_CLS_FINITE = 0,
+  BID_CLS_INF,
+  BID_CLS_QNAN,
+  BID_CLS_SNAN,
+};
+
+#ifdef _MSC_VER
+ #define UMUL128(a, b, xh) _umul128(a, b, xh)
+#else
+static inline uint64_t UMUL128(uint64_t a, uint64_t b, uint64_t* xh) {
+ unsigned __int128 x = (unsigned __int128)a * b;
+ *xh = (uint64_t)(x>>64);
+ return (uint64_t)x;
+}
+#endif
+
+#ifdef _MSC_VER
+static inline unsigned CLZ64(uint64_t x) {
+ unsigned long idx;
+ _BitScanReverse64(&idx, x);
+ return 63 - idx;
+}
+#else
+ #define CLZ64(x) __builtin_clzll(x)
+#endif
+
+typedef struct {
+  uint64_t coef[2]; // coefficient, range [0:10**34-1]
+  int      exp;     // biased exponent
+  unsigned sign;    // 0 or 1
+  unsigned cls;     // BID_CLS_xxx
+} bid_unpacked_t;
+
+static void unpack(bid_unpacked_t* u, const uint64_t x[2])
+{
+  const uint64_t hi = x[1];
+  u->sign = (unsigned)(hi >> 63);
+  u->coef[0] = u->coef[1] = 0;
+  u->exp = 0;
+  if ((hi >> 59 & 15) == 15) {
+    u->cls = (hi >> 58 & 1) == 0 ? BID_CLS_INF : ((hi >> 57 & 1) ? BID_CLS_SNAN : BID_CLS_QNAN);
+    return;
+  }
+  u->cls = BID_CLS_FINITE;
+  if ((hi >> 61 & 3) == 3) { // coefficient >= 2**113, non-canonical
+    u->exp = (int)(hi >> 47 & 0x3FFF);
+    return;
+  }
+  u->exp = (int)(hi >> 49 & 0x3FFF);
+  const uint64_t c1 = hi & (((uint64_t)1 << 49) - 1);
+  if (c1 > divpow10_pow10_tab[34][1] || (c1 == divpow10_pow10_tab[34][1] && x[0] >= divpow10_pow10_tab[34][0]))
+    return; // coefficient >= 10**34, non-canonical
+  u->coef[0] = x[0];
+  u->coef[1] = c1;
+}
+
+static void pack_finite(uint64_t result[2], unsigned sign, int exp, const uint64_t coef[2])
+{
+  result[0] = coef[0];
+  result[1] = ((uint64_t)sign << 63) | ((uint64_t)exp << 49) | coef[1];
+}
+
+static void pack_inf(uint64_t result[2], unsigned sign)
+{
+  result[0] = 0;
+  result[1] = ((uint64_t)sign << 63) | ((uint64_t)0x1E << 58);
+}
+
+static const uint64_t bid_default_nan[2] = { 0, (uint64_t)0x1F << 58 };
+
+// quiet NaN with the payload of x, non-canonical payload replaced by 0
+static void pack_nan(uint64_t result[2], const uint64_t x[2])
+{
+  const uint64_t PAYLOAD_MSK = ((uint64_t)1 << 46) - 1;
+  uint64_t p1 = x[1] & PAYLOAD_MSK;
+  uint64_t p0 = x[0];
+  if (p1 > divpow10_pow10_tab[33][1] || (p1 == divpow10_pow10_tab[33][1] && p0 >= divpow10_pow10_tab[33][0]))
+    p1 = p0 = 0;
+  result[0] = p0;
+  result[1] = (x[1] & ((uint64_t)1 << 63)) | ((uint64_t)0x1F << 58) | p1;
+}
+
+// number of decimal digits in c, 0 for c=0
+static unsigned digits256(const uint64_t c[4])
+{
+  int wi = 3;
+  while (wi >= 0 && c[wi] == 0)
+    --wi;
+  if (wi < 0)
+    return 0;
+  unsigned nbits = wi*64 + 64 - CLZ64(c[wi]);
+  unsigned d = (nbits-1)*1233 >> 12; // floor(log10(2**(nbits-1)))
+  // c >= 10**(d+1) ?
+  const uint64_t* p = divpow10_pow10_tab[d+1];
+  for (int wi = 3; wi >= 0; --wi) {
+    if (c[wi] != p[wi])
+      return c[wi] > p[wi] ? d+2 : d+1;
+  }
+  return d+2;
+}
+
+// number of decimal digits in c, c < 2**128, 0 for c=0
+static unsigned digits128(const uint64_t c[2])
+{
+  unsigned nbits;
+  if (c[1] != 0)
+    nbits = 128 - CLZ64(c[1]);
+  else if (c[0] != 0)
+    nbits = 64 - CLZ64(c[0]);
+  else
+    return 0;
+  unsigned d = (nbits-1)*1233 >> 12; // floor(log10(2**(nbits-1)))
+  // c >= 10**(d+1) ?
+  const uint64_t* p = divpow10_pow10_tab[d+1];
+  return (c[1] > p[1] || (c[1] == p[1] && c[0] >= p[0])) ? d+2 : d+1;
+}
+
+// rounding increment from rounding code of DivideDecimal68ByPowerOf10, BID_ROUND_xxx are the same as DIVPOW10_ROUND_xxx
+static int round_increment(int code, unsigned odd, unsigned sign, unsigned rnd_mode)
+{
+  return (divpow10_round_inc_tab[rnd_mode & 7] >> ((unsigned)code | (odd & 1) << 2 | (sign & 1) << 3)) & 1;
+}
+
+// bid_round_pack - apply rounding to truncated coefficient q and pack the result
+// q < 10**34, code - rounding code of the dropped part, as returned by DivideDecimal68ByPowerOf10
+// tiny - exact result is below 10**-6143 (tininess before rounding)
+static void bid_round_pack(uint64_t result[2], unsigned sign, int exp, const uint64_t q_in[2], int code, int tiny, unsigned rnd_mode, unsigned* flags)
+{
+  uint64_t q[2] = { q_in[0], q_in[1] };
+  if (round_increment(code, (unsigned)q[0] & 1, sign, rnd_mode)) {
+    q[0] += 1;
+    q[1] += (q[0] == 0);
+    if (q[0] == divpow10_pow10_tab[34][0] && q[1] == divpow10_pow10_tab[34][1]) {
+      q[0] = divpow10_pow10_tab[33][0];
+      q[1] = divpow10_pow10_tab[33][1];
+      exp += 1;
+    }
+  }
+  if (code != 0) {
+    *flags |= BID_INEXACT_EXCEPTION;
+    if (tiny)
+      *flags |= BID_UNDERFLOW_EXCEPTION;
+  }
+
+  if (exp > BID_EXP_MAX) {
+    // fold down, when there is room in coefficient
+    const uint64_t c2[4] = { q[0], q[1], 0, 0 };
+    unsigned k = exp - BID_EXP_MAX;
+    if (digits256(c2) + k <= BID_PMAX) {
+      uint64_t h;
+      uint64_t l = UMUL128(q[0], divpow10_pow10_tab[k][0], &h);
+      q[1] = q[1]*divpow10_pow10_tab[k][0] + q[0]*divpow10_pow10_tab[k][1] + h;
+      q[0] = l;
+      exp = BID_EXP_MAX;
+    } else {
+      *flags |= BID_OVERFLOW_EXCEPTION | BID_INEXACT_EXCEPTION;
+      int to_inf = rnd_mode == BID_ROUND_NEAREST_EVEN || rnd_mode == BID_ROUND_NEAREST_AWAY
+                || (rnd_mode == BID_ROUND_UP && !sign) || (rnd_mode == BID_ROUND_DOWN && sign);
+      if (to_inf) {
+        pack_inf(result, sign);
+      } else {
+        const uint64_t max_coef[2] = { divpow10_pow10_tab[34][0] - 1, divpow10_pow10_tab[34][1] }; // 10**34 is not multiple of 2**64
+        pack_finite(result, sign, BID_EXP_MAX, max_coef);
+      }
+      return;
+    }
+  }
+  pack_finite(result, sign, exp, q);
+}
+
+// bid_finish - round sign * (c + sticky) * 10**(exp-BID_EXP_BIAS) to decimal128
+// c < 10**68, exp is biased exponent, not limited to [0:BID_EXP_MAX]
+// sticky != 0 stands for a non-zero fraction in range (0:1) below the last digit of c
+// It is legal only when c has more than BID_PMAX digits, so the fraction never reaches the rounding position
+static void bid_finish(uint64_t result[2], unsigned sign, int exp, const uint64_t c[4], int sticky, unsigned rnd_mode, unsigned* flags)
+{
+  uint64_t q[2] = { c[0], c[1] };
+  unsigned d = digits256(c);
+  if (d == 0) { // exact zero
+    pack_finite(result, sign, exp < 0 ? 0 : (exp > BID_EXP_MAX ? BID_EXP_MAX : exp), q);
+    return;
+  }
+
+  const int exp0 = exp;
+  int code = 0;
+  int n = d > BID_PMAX ? (int)d - BID_PMAX : 0; // number of digits to drop
+  if (exp + n < 0)
+    n = -exp; // below minimal exponent
+  if (n > 0) {
+    if (n <= 34) {
+      code = DivideDecimal68ByPowerOf10(q, c, n);
+    } else if (n <= 68) {
+      uint64_t q1[4] = { 0, 0, 0, 0 };
+      int code1 = DivideDecimal68ByPowerOf10(q1, c, 34); // quotient < 10**34, as required by the kernel
+      code = DivideDecimal68ByPowerOf10(q, q1, n - 34) | (code1 != 0);
+    } else {
+      q[0] = q[1] = 0;
+      code = 1;
+    }
+    exp += n;
+  }
+  code |= (sticky != 0);
+  bid_round_pack(result, sign, exp, q, code, (int)d + exp0 <= BID_PMAX-1, rnd_mode, flags);
+}
+
+static int is_zero256(const uint64_t a[4])
+{
+  return (a[0] | a[1] | a[2] | a[3]) == 0;
+}
+
+static int cmp256(const uint64_t a[4], const uint64_t b[4])
+{
+  for (int wi = 3; wi >= 0; --wi) {
+    if (a[wi] != b[wi])
+      return a[wi] > b[wi] ? 1 : -1;
+  }
+  return 0;
+}
+
+// r = a + b, modulo 2**256
+static void add256(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+  uint64_t carry = 0;
+  for (int wi = 0; wi < 4; ++wi) {
+    uint64_t s = a[wi] + carry;
+    carry = (s < carry);
+    r[wi] = s + b[wi];
+    carry += (r[wi] < s);
+  }
+}
+
+// r = a - b, modulo 2**256
+static void sub256(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+  uint64_t borrow = 0;
+  for (int wi = 0; wi < 4; ++wi) {
+    uint64_t s = a[wi] - b[wi];
+    uint64_t bw = (a[wi] < b[wi]);
+    r[wi] = s - borrow;
+    borrow = bw | (s < borrow);
+  }
+}
+
+// r = a * 10**k, modulo 2**256, k <= 68
+static void mul256_pow10(uint64_t r[4], const uint64_t a[4], unsigned k)
+{
+  const uint64_t* p = divpow10_pow10_tab[k];
+  uint64_t acc[4] = { 0, 0, 0, 0 };
+  for (int i = 0; i < 4; ++i) {
+    if (a[i] == 0)
+      continue;
+    uint64_t carry = 0;
+    for (int j = 0; i + j < 4; ++j) {
+      uint64_t h;
+      uint64_t l = UMUL128(a[i], p[j], &h);
+      l += carry;
+      h += (l < carry);
+      acc[i+j] += l;
+      h += (acc[i+j] < l);
+      carry = h;
+    }
+  }
+  r[0] = acc[0]; r[1] = acc[1]; r[2] = acc[2]; r[3] = acc[3];
+}
+
+// c = floor(c / 10), returns remainder
+static unsigned div10_256(uint64_t c[4])
+{
+  uint64_t rem = 0;
+  for (int wi = 3; wi >= 0; --wi) {
+    uint64_t h = (rem << 32) | (c[wi] >> 32);
+    uint64_t qh = h / 10;
+    uint64_t l = ((h - qh*10) << 32) | (uint32_t)c[wi];
+    uint64_t ql = l / 10;
+    rem = l - ql*10;
+    c[wi] = (qh << 32) | ql;
+  }
+  return (unsigned)rem;
+}
+
+// q = floor(c / 10**m), returns non-zero when the remainder is non-zero
+// c < 10**68, d = number of digits in c, 0 < m < d
+static int shift_right_sticky(uint64_t q[4], const uint64_t c[4], unsigned d, unsigned m)
+{
+  q[2] = q[3] = 0;
+  if (m <= 34 && d <= m + 34) // quotient < 10**34, single step
+    return DivideDecimal68ByPowerOf10(q, c, m) != 0;
+
+  // split c into 34-digit halves: c = h * 10**34 + l
+  uint64_t h[4] = { 0, 0, 0, 0 };
+  uint64_t t[4], l[4] = { 0, 0, 0, 0 };
+  int code_h = DivModDecimal68ByPowerOf10(h, l, c, 34);
+  if (m > 34)
+    return (DivideDecimal68ByPowerOf10(q, h, m - 34) | code_h) != 0;
+
+  uint64_t lq[4] = { 0, 0, 0, 0 };
+  int code_l = DivideDecimal68ByPowerOf10(lq, l, m);
+  mul256_pow10(t, h, 34 - m);
+  add256(q, t, lq);
+  return code_l != 0;
+}
+
+// bid_add_finish - round (-1)**sa * a * 10**(ea-BID_EXP_BIAS) + (-1)**sb * b * 10**(eb-BID_EXP_BIAS) to decimal128
+// a, b < 10**68, exponents are biased, not limited to [0:BID_EXP_MAX]
+static void bid_add_finish(uint64_t result[2],
+  unsigned sa, int ea, const uint64_t a[4],
+  unsigned sb, int eb, const uint64_t b[4],
+  unsigned rnd_mode, unsigned* flags)
+{
+  // hi is the operand with the bigger exponent
+  const int swap = ea < eb;
+  const uint64_t* hi = swap ? b : a;
+  const uint64_t* lo = swap ? a : b;
+  const unsigned s_hi = swap ? sb : sa;
+  const unsigned s_lo = swap ? sa : sb;
+  const int e_hi = swap ? eb : ea;
+  const int e_lo = swap ? ea : eb;
+  const unsigned k = e_hi - e_lo;
+  const unsigned d_hi = digits256(hi);
+
+  uint64_t hs[4], ls[4]; // hi and lo, scaled to the common exponent
+  int exp, sticky = 0;
+  if (d_hi == 0) {
+    // the result is lo, exact, with preferred exponent e_lo
+    memcpy(hs, hi, sizeof(hs));
+    memcpy(ls, lo, sizeof(ls));
+    exp = e_lo;
+  } else if (d_hi + k <= 69) {
+    // exact alignment, hi*10**k < 10**69
+    mul256_pow10(hs, hi, k);
+    memcpy(ls, lo, sizeof(ls));
+    exp = e_lo;
+  } else {
+    // operands are at least 2 digits apart, so the sum has at least 66 digits.
+    // Scale hi to 67 digits and lo down to the same exponent, remainder of lo becomes sticky.
+    const unsigned d_lo = digits256(lo);
+    const unsigned j = d_hi < 67 ? 67 - d_hi : 0;
+    const unsigned m = k - j;
+    mul256_pow10(hs, hi, j);
+    exp = e_hi - j;
+    if (m >= d_lo) {
+      ls[0] = ls[1] = ls[2] = ls[3] = 0;
+      sticky = d_lo != 0;
+    } else {
+      sticky = shift_right_sticky(ls, lo, d_lo, m);
+    }
+  }
+
+  uint64_t t[4];
+  unsigned sign = s_hi;
+  if (s_hi == s_lo) {
+    add256(t, hs, ls);
+  } else if (cmp256(hs, ls) > 0) {
+    sub256(t, hs, ls);
+    if (sticky) { // hs - (ls + frac) = (hs - ls - 1) + (1 - frac)
+      const uint64_t one[4] = { 1, 0, 0, 0 };
+      sub256(t, t, one);
+    }
+  } else {
+    // sticky is possible only when hs has more digits than ls
+    sub256(t, ls, hs);
+    sign = s_lo;
+    if (is_zero256(t)) // exact zero, sign depends on rounding mode
+      sign = rnd_mode == BID_ROUND_DOWN;
+  }
+
+  while (cmp256(t, divpow10_pow10_tab[68]) >= 0) {
+    sticky |= div10_256(t) != 0;
+    exp += 1;
+  }
+  bid_finish(result, sign, exp, t, sticky, rnd_mode, flags);
+}
+
+// 113x113-bit product of coefficients
+static void mul_coef(uint64_t c[4], const uint64_t a[2], const uint64_t b[2])
+{
+  uint64_t h00, h01, h10, h11;
+  uint64_t l00 = UMUL128(a[0], b[0], &h00);
+  uint64_t l01 = UMUL128(a[0], b[1], &h01);
+  uint64_t l10 = UMUL128(a[1], b[0], &h10);
+  uint64_t l11 = UMUL128(a[1], b[1], &h11);
+  uint64_t w1 = h00 + l01;
+  uint64_t w2 = h01 + (w1 < l01);
+  w1 += l10;
+  w2 += (w1 < l10);
+  uint64_t w3 = h11;
+  w2 += h10;
+  w3 += (w2 < h10);
+  w2 += l11;
+  w3 += (w2 < l11);
+  c[0] = l00;
+  c[1] = w1;
+  c[2] = w2;
+  c[3] = w3;
+}
+
+void Bid128Mul(uint64_t result[2], const uint64_t x[2], const uint64_t y[2], unsigned rnd_mode, unsigned* flags)
+{
+  bid_unpacked_t a, b;
+  unpack(&a, x);
+  unpack(&b, y);
+  const unsigned sign = a.sign ^ b.sign;
+
+  if (a.cls >= BID_CLS_QNAN || b.cls >= BID_CLS_QNAN) {
+    if (a.cls == BID_CLS_SNAN || b.cls == BID_CLS_SNAN)
+      *flags |= BID_INVALID_EXCEPTION;
+    pack_nan(result, a.cls >= BID_CLS_QNAN ? x : y);
+    return;
+  }
+  if (a.cls == BID_CLS_INF || b.cls == BID_CLS_INF) {
+    const int a_zero = a.cls == BID_CLS_FINITE && (a.coef[0] | a.coef[1]) == 0;
+    const int b_zero = b.cls == BID_CLS_FINITE && (b.coef[0] | b.coef[1]) == 0;
+    if (a_zero || b_zero) { // Inf * 0
+      *flags |= BID_INVALID_EXCEPTION;
+      pack_nan(result, bid_default_nan);
+      return;
+    }
+    pack_inf(result, sign);
+    return;
+  }
+
+  uint64_t c[4];
+  mul_coef(c, a.coef, b.coef);
+  bid_finish(result, sign, a.exp + b.exp - BID_EXP_BIAS, c, 0, rnd_mode, flags);
+}
+
+// bid_add_coef128 - bid_add_finish for canonical decimal128 operands, a, b < 10**34, ea, eb in [0:BID_EXP_MAX]
+// Operands that overlap within 38 digits are aligned and added in 128-bit arithmetic.
+// When b is entirely below the rounding position of a (or vice versa), it contributes only the sticky bit
+// and the result is rounded without a division.
+static void bid_add_coef128(uint64_t result[2],
+  unsigned sa, int ea, const uint64_t a[2],
+  unsigned sb, int eb, const uint64_t b[2],
+  unsigned rnd_mode, unsigned* flags)
+{
+  const int swap = ea < eb;
+  const uint64_t* hi = swap ? b : a;
+  const uint64_t* lo = swap ? a : b;
+  const unsigned s_hi = swap ? sb : sa;
+  const unsigned s_lo = swap ? sa : sb;
+  const int e_hi = swap ? eb : ea;
+  const int e_lo = swap ? ea : eb;
+  const unsigned k = e_hi - e_lo;
+  const unsigned d_hi = digits128(hi);
+
+  if (d_hi != 0 && d_hi + k <= 38) {
+    // exact alignment, hi*10**k < 10**38, the sum fits in 128 bits
+    uint64_t t[4] = { hi[0], hi[1], 0, 0 };
+    if (k != 0) {
+      uint64_t h;
+      t[0] = UMUL128(hi[0], divpow10_pow10_tab[k][0], &h);
+      t[1] = hi[1]*divpow10_pow10_tab[k][0] + hi[0]*divpow10_pow10_tab[k][1] + h;
+    }
+    unsigned sign = s_hi;
+    if (s_hi == s_lo) {
+      t[0] += lo[0];
+      t[1] += lo[1] + (t[0] < lo[0]);
+    } else if (t[1] > lo[1] || (t[1] == lo[1] && t[0] >= lo[0])) {
+      t[1] -= lo[1] + (t[0] < lo[0]);
+      t[0] -= lo[0];
+      if ((t[0] | t[1]) == 0) // exact zero, sign depends on rounding mode
+        sign = rnd_mode == BID_ROUND_DOWN;
+    } else {
+      uint64_t l0 = lo[0] - t[0];
+      t[1] = lo[1] - t[1] - (lo[0] < t[0]);
+      t[0] = l0;
+      sign = s_lo;
+    }
+    if (t[1] < divpow10_pow10_tab[34][1] || (t[1] == divpow10_pow10_tab[34][1] && t[0] < divpow10_pow10_tab[34][0])) {
+      pack_finite(result, sign, e_lo, t); // exact
+      return;
+    }
+    bid_finish(result, sign, e_lo, t, 0, rnd_mode, flags);
+    return;
+  }
+
+  const unsigned d_lo = digits128(lo);
+  const unsigned j = 34 - d_hi;
+  if (d_hi != 0 && d_lo != 0 && k > j + d_lo) {
+    // lo < 10**(k-j-1), i.e. below 1/10 of the last digit of hi scaled to 34 digits. Only sticky matters.
+    uint64_t q[2] = { hi[0], hi[1] };
+    if (j != 0) {
+      uint64_t h;
+      q[0] = UMUL128(hi[0], divpow10_pow10_tab[j][0], &h);
+      q[1] = hi[1]*divpow10_pow10_tab[j][0] + hi[0]*divpow10_pow10_tab[j][1] + h;
+    }
+    int code = 1; // hi + lo: fraction in range (0:0.1)
+    if (s_hi != s_lo) {
+      // hi - lo = (hi - 1) + fraction in range (0.9:1), unless hi - 1 drops to 33 digits
+      if (q[0] == divpow10_pow10_tab[33][0] && q[1] == divpow10_pow10_tab[33][1]) {
+        const uint64_t ac[4] = { a[0], a[1], 0, 0 };
+        const uint64_t bc[4] = { b[0], b[1], 0, 0 };
+        bid_add_finish(result, sa, ea, ac, sb, eb, bc, rnd_mode, flags);
+        return;
+      }
+      q[1] -= (q[0] == 0);
+      q[0] -= 1;
+      code = 3;
+    }
+    bid_round_pack(result, s_hi, e_hi - j, q, code, 0, rnd_mode, flags);
+    return;
+  }
+
+  const uint64_t ac[4] = { a[0], a[1], 0, 0 };
+  const uint64_t bc[4] = { b[0], b[1], 0, 0 };
+  bid_add_finish(result, sa, ea, ac, sb, eb, bc, rnd_mode, flags);
+}
+
+void Bid128Fma(uint64_t result[2], const uint64_t x[2], const uint64_t y[2], const uint64_t z[2], unsigned rnd_mode, unsigned* flags)
+{
+  bid_unpacked_t a, b, c;
+  unpack(&a, x);
+  unpack(&b, y);
+  unpack(&c, z);
+  const unsigned sign = a.sign ^ b.sign;
+
+  if (a.cls >= BID_CLS_QNAN || b.cls >= BID_CLS_QNAN || c.cls >= BID_CLS_QNAN) {
+    if (a.cls == BID_CLS_SNAN || b.cls == BID_CLS_SNAN || c.cls == BID_CLS_SNAN)
+      *flags |= BID_INVALID_EXCEPTION;
+    pack_nan(result, a.cls >= BID_CLS_QNAN ? x : (b.cls >= BID_CLS_QNAN ? y : z));
+    return;
+  }
+  if (a.cls == BID_CLS_INF || b.cls == BID_CLS_INF) {
+    const int a_zero = a.cls == BID_CLS_FINITE && (a.coef[0] | a.coef[1]) == 0;
+    const int b_zero = b.cls == BID_CLS_FINITE && (b.coef[0] | b.coef[1]) == 0;
+    if (a_zero || b_zero || (c.cls == BID_CLS_INF && c.sign != sign)) { // Inf * 0 or Inf - Inf
+      *flags |= BID_INVALID_EXCEPTION;
+      pack_nan(result, bid_default_nan);
+      return;
+    }
+    pack_inf(result, sign);
+    return;
+  }
+  if (c.cls == BID_CLS_INF) {
+    pack_inf(result, c.sign);
+    return;
+  }
+
+  uint64_t p[4];
+  mul_coef(p, a.coef, b.coef);
+  const uint64_t cc[4] = { c.coef[0], c.coef[1], 0, 0 };
+  bid_add_finish(result, sign, a.exp + b.exp - BID_EXP_BIAS, p, c.sign, c.exp, cc, rnd_mode, flags);
+}
+
+void Bid128Add(uint64_t result[2], const uint64_t x[2], const uint64_t y[2], unsigned rnd_mode, unsigned* flags)
+{
+  bid_unpacked_t a, b;
+  unpack(&a, x);
+  unpack(&b, y);
+
+  if (a.cls >= BID_CLS_QNAN || b.cls >= BID_CLS_QNAN) {
+    if (a.cls == BID_CLS_SNAN || b.cls == BID_CLS_SNAN)
+      *flags |= BID_INVALID_EXCEPTION;
+    pack_nan(result, a.cls >= BID_CLS_QNAN ? x : y);
+    return;
+  }
+  if (a.cls == BID_CLS_INF || b.cls == BID_CLS_INF) {
+    if (a.cls == BID_CLS_INF && b.cls == BID_CLS_INF && a.sign != b.sign) { // Inf - Inf
+      *flags |= BID_INVALID_EXCEPTION;
+      pack_nan(result, bid_default_nan);
+      return;
+    }
+    pack_inf(result, a.cls == BID_CLS_INF ? a.sign : b.sign);
+    return;
+  }
+
+  bid_add_coef128(result, a.sign, a.exp, a.coef, b.sign, b.exp, b.coef, rnd_mode, flags);
+}
+
+void Bid128Sub(uint64_t result[2], const uint64_t x[2], const uint64_t y[2], unsigned rnd_mode, unsigned* flags)
+{
+  uint64_t ny[2] = { y[0], y[1] };
+  if ((y[1] >> 58 & 31) != 31) // NaN keeps its sign
+    ny[1] ^= (uint64_t)1 << 63;
+  Bid128Add(result, x, ny, rnd_mode, flags);
+}
+
+// 8 decimal digits of x < 10**8 as ASCII characters, most significant digit in the LS byte,
+// i.e. in string order when stored on Little Endian machine
+// All 8 digits are computed in parallel in 32-, 16- and 8-bit lanes of 64-bit word (SWAR)
+static inline uint64_t ascii8(uint32_t x)
+{
+  uint64_t v = (x / 10000) | ((uint64_t)(x % 10000) << 32);         // 2 lanes of 4 digits
+  uint64_t h = ((v * 10486) >> 20) & (((uint64_t)0x7F << 32) | 0x7F); // lane/100, exact for lane < 43699
+  v = ((v - h * 100) << 16) | h;                                       // 4 lanes of 2 digits
+  h = ((v * 103) >> 10) & 0x000F000F000F000Full;                       // lane/10, exact for lane < 179
+  v = ((v - h * 10) << 8) | h;                                         // 8 lanes of 1 digit
+  return v + 0x3030303030303030ull;
+}
+
+// coefficient c < 2**113 as 40 ASCII digits, with leading zeros
+static void coef_ascii40(char buf[40], const uint64_t c[2])
+{
+  const uint64_t POW10_8  = 100000000;
+  const uint64_t POW10_16 = POW10_8 * POW10_8;
+  // c = hi * 10**16 + lo
+  uint64_t hi = 0, lo = c[0];
+  if (c[1] != 0 || c[0] >= POW10_16) {
+    const uint64_t src[4] = { c[0], c[1], 0, 0 };
+    uint64_t q[2], r[2];
+    DivModDecimal68ByPowerOf10(q, r, src, 16);
+    hi = q[0]; // < 2**113/10**16 < 2**60
+    lo = r[0];
+  }
+  const uint64_t top = hi / POW10_16, mid = hi % POW10_16; // top < 104
+  uint64_t w[5];
+  w[0] = ascii8((uint32_t)top);
+  w[1] = ascii8((uint32_t)(mid / POW10_8));
+  w[2] = ascii8((uint32_t)(mid % POW10_8));
+  w[3] = ascii8((uint32_t)(lo / POW10_8));
+  w[4] = ascii8((uint32_t)(lo % POW10_8));
+  memcpy(buf, w, 40);
+}
+
+// decimal digits of x < 10**4, returns number of characters written
+static unsigned exp_ascii(char* str, unsigned x)
+{
+  char buf[8];
+  uint64_t w = ascii8(x);
+  memcpy(buf, &w, 8);
+  unsigned nd = 1 + (x >= 10) + (x >= 100) + (x >= 1000);
+  memcpy(str, buf + 8 - nd, nd);
+  return nd;
+}
+
+int Bid128ToString(char* str, const uint64_t x[2])
+{
+  bid_unpacked_t u;
+  unpack(&u, x);
+  char* p = str;
+  *p = '-';
+  p += u.sign;
+
+  char digits[40];
+  unsigned nd;
+  if (u.cls != BID_CLS_FINITE) {
+    if (u.cls == BID_CLS_INF) {
+      memcpy(p, "Infinity", 9);
+      return (int)(p - str) + 8;
+    }
+    if (u.cls == BID_CLS_SNAN)
+      *p++ = 's';
+    memcpy(p, "NaN", 3);
+    p += 3;
+    uint64_t payload[2];
+    pack_nan(payload, x);
+    payload[1] &= ((uint64_t)1 << 46) - 1;
+    nd = digits128(payload);
+    coef_ascii40(digits, payload);
+    memcpy(p, digits + 40 - nd, nd);
+    p[nd] = 0;
+    return (int)(p - str) + nd;
+  }
+
+  coef_ascii40(digits, u.coef);
+  nd = digits128(u.coef);
+  nd += (nd == 0);
+  const char* d = digits + 40 - nd;
+  const int e = u.exp - BID_EXP_BIAS;
+  const int adj = e + (int)nd - 1; // exponent of the leading digit
+  if (e <= 0 && adj >= -6) {
+    // plain notation
+    int ip = (int)nd + e; // digits before decimal point
+    if (ip > 0) {
+      memcpy(p, d, ip);
+      p += ip;
+      if (e != 0) {
+        *p++ = '.';
+        memcpy(p, d + ip, -e);
+        p -= e;
+      }
+    } else {
+      memcpy(p, "0.000000", 2 - ip); // -ip <= 6
+      p += 2 - ip;
+      memcpy(p, d, nd);
+      p += nd;
+    }
+  } else {
+    // scientific notation
+    *p++ = d[0];
+    if (nd > 1) {
+      *p++ = '.';
+      memcpy(p, d + 1, nd - 1);
+      p += nd - 1;
+    }
+    *p++ = 'E';
+    *p++ = adj < 0 ? '-' : '+';
+    p += exp_ascii(p, adj < 0 ? -adj : adj);
+  }
+  *p = 0;
+  return (int)(p - str);
+}
+
+// all 8 characters of w are decimal digits
+static inline int is_digits8(uint64_t w)
+{
+  return ((w & 0xF0F0F0F0F0F0F0F0ull) | (((w + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+// value of 8 ASCII digits, first character in the LS byte
+// Pairs, quads and octets of digits are combined in parallel, 3 multiplications in total
+static inline uint32_t value8(uint64_t w)
+{
+  w = ((w & 0x0F0F0F0F0F0F0F0Full) * (1 + (10 << 8))) >> 8;
+  w = ((w & 0x00FF00FF00FF00FFull) * (1 + (100 << 16))) >> 16;
+  return (uint32_t)(((w & 0x0000FFFF0000FFFFull) * (1 + (10000ull << 32))) >> 32);
+}
+
+enum {
+  BID_PARSE_DIGITS_MAX = 68, // significant digits kept by the parser, more digits only contribute to sticky
+};
+
+// significant digits of decimal string
+typedef struct {
+  uint64_t c[4];   // coefficient, except the pending digits
+  uint64_t cur;    // pending digits, cur < 10**ncur
+  unsigned ncur;   // number of pending digits, at most 19
+  unsigned nsig;   // number of significant digits in c and cur, at most BID_PARSE_DIGITS_MAX
+  size_t   ndrop;  // number of significant digits beyond BID_PARSE_DIGITS_MAX
+  uint64_t sticky; // non-zero when one of dropped digits is non-zero
+} bid_digits_t;
+
+// c = c * 10**ncur + cur
+static void digits_fold(bid_digits_t* a)
+{
+  if (a->ncur == a->nsig) { // c = 0, the common case of short numbers
+    a->c[0] = a->cur;
+    a->cur = 0;
+    a->ncur = 0;
+    return;
+  }
+  const uint64_t m = divpow10_pow10_tab[a->ncur][0];
+  uint64_t carry = a->cur;
+  for (int i = 0; i < 4; ++i) {
+    uint64_t h;
+    uint64_t l = UMUL128(a->c[i], m, &h);
+    l += carry;
+    h += (l < carry);
+    a->c[i] = l;
+    carry = h;
+  }
+  a->cur = 0;
+  a->ncur = 0;
+}
+
+// append run of digits at s[0:len) to a, returns number of characters consumed
+static size_t scan_digits(bid_digits_t* a, const char* s, size_t len)
+{
+  size_t i = 0;
+  if (a->nsig == 0) {
+    while (i < len && s[i] == '0') // leading zeros are not significant
+      ++i;
+  }
+  // 8 digits at time
+  while (i + 8 <= len && a->nsig + 8 <= BID_PARSE_DIGITS_MAX) {
+    uint64_t w;
+    memcpy(&w, s + i, sizeof(w));
+    if (!is_digits8(w))
+      break;
+    if (a->ncur > 19 - 8)
+      digits_fold(a);
+    a->cur = a->cur * 100000000 + value8(w);
+    a->ncur += 8;
+    a->nsig += 8;
+    i += 8;
+  }
+  for (; i < len; ++i) {
+    const unsigned d = (unsigned char)s[i] - '0';
+    if (d > 9)
+      break;
+    if (a->nsig == BID_PARSE_DIGITS_MAX) {
+      // beyond kept digits
+      while (i + 8 <= len) {
+        uint64_t w;
+        memcpy(&w, s + i, sizeof(w));
+        if (!is_digits8(w))
+          break;
+        a->sticky |= w ^ 0x3030303030303030ull;
+        a->ndrop += 8;
+        i += 8;
+      }
+      for (; i < len && (unsigned)((unsigned char)s[i] - '0') <= 9; ++i) {
+        a->sticky |= s[i] - '0';
+        a->ndrop += 1;
+      }
+      break;
+    }
+    if (a->ncur == 19)
+      digits_fold(a);
+    a->cur = a->cur * 10 + d;
+    a->ncur += 1;
+    a->nsig += 1;
+  }
+  return i;
+}
+
+// length of the prefix of s that matches lower-case word, ignoring case, 0 when it doesn't match
+static size_t match_word(const char* s, size_t len, const char* word)
+{
+  size_t i;
+  for (i = 0; word[i] != 0; ++i) {
+    if (i == len || (s[i] | 0x20) != word[i])
+      return 0;
+  }
+  return i;
+}
+
+// Inf, Infinity, NaN or sNaN with optional payload, at s[0:len)
+// returns number of characters consumed, 0 when s is not a special value
+static size_t parse_special(uint64_t result[2], unsigned sign, const char* s, size_t len, unsigned* flags)
+{
+  size_t i;
+  if ((i = match_word(s, len, "inf")) != 0) {
+    size_t k = match_word(s + i, len - i, "inity");
+    pack_inf(result, sign);
+    return i + k;
+  }
+  unsigned snan = 0;
+  if ((i = match_word(s, len, "nan")) == 0) {
+    if ((i = match_word(s, len, "snan")) == 0)
+      return 0;
+    snan = 1;
+  }
+  bid_digits_t a;
+  memset(&a, 0, sizeof(a));
+  i += scan_digits(&a, s + i, len - i);
+  digits_fold(&a);
+  if (a.nsig > BID_PMAX-1) { // payload too long
+    result[0] = bid_default_nan[0];
+    result[1] = bid_default_nan[1];
+    *flags |= BID_INVALID_EXCEPTION;
+    return i;
+  }
+  result[0] = a.c[0];
+  result[1] = ((uint64_t)sign << 63) | ((uint64_t)(0x3E | snan) << 57) | a.c[1];
+  return i;
+}
+
+size_t Bid128FromString(uint64_t result[2], const char* str, size_t len, unsigned rnd_mode, unsigned* flags)
+{
+  size_t i = 0;
+  unsigned sign = 0;
+  if (len != 0 && (str[0] == '+' || str[0] == '-')) {
+    sign = str[0] == '-';
+    i = 1;
+  }
+
+  bid_digits_t a;
+  memset(&a, 0, sizeof(a));
+  const size_t nint = scan_digits(&a, str + i, len - i);
+  i += nint;
+  size_t nfrac = 0;
+  if (i < len && str[i] == '.') {
+    nfrac = scan_digits(&a, str + i + 1, len - i - 1);
+    if (nint + nfrac != 0)
+      i += 1 + nfrac;
+  }
+  if (nint + nfrac == 0) {
+    size_t k = parse_special(result, sign, str + i, len - i, flags);
+    if (k == 0) {
+      result[0] = bid_default_nan[0];
+      result[1] = bid_default_nan[1];
+      *flags |= BID_INVALID_EXCEPTION;
+      return 0;
+    }
+    return i + k;
+  }
+
+  // exponent, saturated far outside of decimal128 range
+  long long e = 0;
+  if (i < len && (str[i] | 0x20) == 'e') {
+    size_t j = i + 1;
+    int eneg = 0;
+    if (j < len && (str[j] == '+' || str[j] == '-')) {
+      eneg = str[j] == '-';
+      ++j;
+    }
+    const size_t j0 = j;
+    for (; j < len && (unsigned)((unsigned char)str[j] - '0') <= 9; ++j) {
+      if (e < 100000000)
+        e = e * 10 + (str[j] - '0');
+    }
+    if (j != j0) {
+      i = j;
+      e = eneg ? -e : e;
+    } else {
+      e = 0; // not an exponent, e.g. 1E or 1E+
+    }
+  }
+  digits_fold(&a);
+
+  const long long EXP_LIM = 1 << 24;
+  long long exp = e - (long long)nfrac + (long long)a.ndrop + BID_EXP_BIAS;
+  exp = exp > EXP_LIM ? EXP_LIM : (exp < -EXP_LIM ? -EXP_LIM : exp);
+  if (a.nsig <= BID_PMAX && exp >= 0 && exp <= BID_EXP_MAX) {
+    pack_finite(result, sign, (int)exp, a.c); // exact
+    return i;
+  }
+  bid_finish(result, sign, (int)exp, a.c, a.sticky != 0, rnd_mode, flags);
+  return i;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// IEEE 754-2008 decimal128 arithmetic, binary integer decimal (BID) encoding
+// Operands and results are 2 64-bit words, Little Endian, i.e. x[1] holds sign, combination field
+// and the upper part of the coefficient.
+
+enum { // rounding modes, the same values as in Intel Decimal Floating-Point Math Library
+  BID_ROUND_NEAREST_EVEN = 0,
+  BID_ROUND_DOWN         = 1, // toward -Inf
+  BID_ROUND_UP           = 2, // toward +Inf
+  BID_ROUND_ZERO         = 3, // toward zero
+  BID_ROUND_NEAREST_AWAY = 4,
+};
+
+enum { // exception flags, the same values as in Intel Decimal Floating-Point Math Library
+  BID_INVALID_EXCEPTION   = 0x01,
+  BID_OVERFLOW_EXCEPTION  = 0x08,
+  BID_UNDERFLOW_EXCEPTION = 0x10,
+  BID_INEXACT_EXCEPTION   = 0x20,
+};
+
+// Bid128Mul - Multiply two decimal128 numbers
+//
+// Arguments:
+// result   - x*y, rounded according to rnd_mode
+// x, y     - operands
+// rnd_mode - one of BID_ROUND_xxx
+// flags    - BID_xxx_EXCEPTION flags raised by the operation are ORed into *flags
+//
+// Comments:
+// 1. Non-canonical operands are treated as zeros, signaling NaNs raise invalid and are quieted
+// 2. Exact results have preferred exponent ex+ey, inexact results have 34 digits, tininess is detected before rounding
+void Bid128Mul(uint64_t result[2], const uint64_t x[2], const uint64_t y[2], unsigned rnd_mode, unsigned* flags);
+
+// Bid128Fma - Fused multiply-add of decimal128 numbers
+//
+// Arguments:
+// result   - x*y+z, rounded once according to rnd_mode
+// x, y, z  - operands
+// rnd_mode - one of BID_ROUND_xxx
+// flags    - BID_xxx_EXCEPTION flags raised by the operation are ORed into *flags
+//
+// Comments:
+// 1. The exact 68-digit product is aligned against z and the sum is rounded once
+// 2. When one of the operands is NaN, the result is the first NaN operand, quieted.
+//    Inf*0 and Inf-Inf raise invalid and return default NaN.
+void Bid128Fma(uint64_t result[2], const uint64_t x[2], const uint64_t y[2], const uint64_t z[2], unsigned rnd_mode, unsigned* flags);
+
+// Bid128Add - Add two decimal128 numbers
+//
+// Arguments:
+// result   - x+y, rounded according to rnd_mode
+// x, y     - operands
+// rnd_mode - one of BID_ROUND_xxx
+// flags    - BID_xxx_EXCEPTION flags raised by the operation are ORed into *flags
+//
+// Comments:
+// Exact results have preferred exponent min(ex,ey). Exact zero sum of operands of opposite signs is +0,
+// or -0 when rnd_mode=BID_ROUND_DOWN.
+void Bid128Add(uint64_t result[2], const uint64_t x[2], const uint64_t y[2], unsigned rnd_mode, unsigned* flags);
+
+// Bid128Sub - Subtract two decimal128 numbers
+//
+// Arguments:
+// result   - x-y, rounded according to rnd_mode
+// x, y     - operands
+// rnd_mode - one of BID_ROUND_xxx
+// flags    - BID_xxx_EXCEPTION flags raised by the operation are ORed into *flags
+//
+// Comments:
+// The same as Bid128Add(x, -y), except that NaN y is returned with its own sign
+void Bid128Sub(uint64_t result[2], const uint64_t x[2], const uint64_t y[2], unsigned rnd_mode, unsigned* flags);
+
+enum {
+  BID128_STRING_MAX = 48, // size of output buffer of Bid128ToString, including terminating zero
+};
+
+// Bid128ToString - Convert decimal128 number to character string
+//
+// Arguments:
+// str - output buffer, at least BID128_STRING_MAX characters, receives zero-terminated string
+// x   - operand
+// Return value: length of the string, not counting terminating zero
+//
+// Comments:
+// 1. The format is to-scientific-string of General Decimal Arithmetic, the same as str() of Python Decimal:
+//    plain notation, e.g. 123.45 or 0.00012, when exponent <= 0 and exponent of the leading digit >= -6,
+//    otherwise scientific, e.g. 1.2345E+7. Special values are Infinity, NaN and sNaN, followed by NaN payload, if any.
+// 2. Coefficient is split into 16-digit chunks with a single DivModDecimal68ByPowerOf10 call,
+//    then digits are produced 8 at time by SWAR arithmetic, without division loops
+int Bid128ToString(char* str, const uint64_t x[2]);
+
+// Bid128FromString - Convert character string to decimal128 number
+//
+// Arguments:
+// result   - converted value, rounded to 34 digits according to rnd_mode
+// str      - characters to convert, no terminating zero is required
+// len      - number of characters in str
+// rnd_mode - one of BID_ROUND_xxx
+// flags    - BID_xxx_EXCEPTION flags raised by the conversion are ORed into *flags
+// Return value: number of characters consumed, 0 when str does not start with a number
+//
+// Comments:
+// 1. Syntax is numeric-string of General Decimal Arithmetic: [sign] digits [. [digits]] [E [sign] digits],
+//    or [sign] . digits ..., or [sign] Inf, Infinity, NaN [digits], sNaN [digits], case-insensitive.
+//    Conversion stops at the first character that doesn't fit the syntax.
+// 2. When str does not start with a number, or NaN payload is longer than 33 digits, the result is NaN and
+//    invalid exception is raised
+// 3. Up to 68 significant digits are accumulated 8 at time by SWAR arithmetic, more digits only contribute to
+//    sticky bit. Coefficients longer than 34 digits are rounded by DivideDecimal68ByPowerOf10.
+size_t Bid128FromString(uint64_t result[2], const char* str, size_t len, unsigned rnd_mode, unsigned* flags);
@@ -0,0 +1,455 @@
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+
+extern "C" {
+#include "bid128.h"
+};
+#include "bid128_test_vectors.h"
+#include "multiprec_ut.h"
+
+typedef void (*bid128_op3_fn)(uint64_t result[2], const uint64_t x[2], const uint64_t y[2], const uint64_t z[2], unsigned rnd_mode, unsigned* flags);
+
+static void mul_op3(uint64_t result[2], const uint64_t x[2], const uint64_t y[2], const uint64_t[2], unsigned rnd_mode, unsigned* flags)
+{
+  Bid128Mul(result, x, y, rnd_mode, flags);
+}
+
+static void add_op3(uint64_t result[2], const uint64_t x[2], const uint64_t y[2], const uint64_t[2], unsigned rnd_mode, unsigned* flags)
+{
+  Bid128Add(result, x, y, rnd_mode, flags);
+}
+
+static void sub_op3(uint64_t result[2], const uint64_t x[2], const uint64_t y[2], const uint64_t[2], unsigned rnd_mode, unsigned* flags)
+{
+  Bid128Sub(result, x, y, rnd_mode, flags);
+}
+
+static bool vectors_test(const char* name, bid128_op3_fn op, const bid128_test_vector_t* vec, int nVec);
+static bool str_test();
+static bool parse_test();
+static void time_test(int nInps, int nIter);
+static void format_time_test(int nInps, int nIter);
+static void parse_time_test(int nInps, int nIter);
+
+int main(int argz, char**argv)
+{
+  if (argz < 2)
+  {
+    fprintf(stderr,
+      "bid128_test - test speed and correctness of decimal128 arithmetic routines.\n"
+      "Usage:\n"
+      "bid128_test nInps [nIter]\n"
+      "where\n"
+      " nInps   - # elements in test vector\n"
+      " nIter   - number of iterations. Default=17\n"
+      );
+    return 1;
+  }
+
+  char* endp;
+  int nInps = strtol(argv[1], &endp, 0);
+  if (endp == argv[1]) {
+    fprintf(stderr, "Bad argument nInps='%s'. Not a number.\n", argv[1]);
+    return 1;
+  }
+
+  int nIter = 17;
+  if (argz >= 3) {
+    nIter = strtol(argv[2], &endp, 0);
+    if (endp == argv[2]) {
+      fprintf(stderr, "Bad argument nIter='%s'. Not a number.\n", argv[2]);
+      return 1;
+    }
+  }
+
+  if (nInps < 1 || nInps > 1e8) {
+    fprintf(stderr, "Bad argument nInps='%s'. Please specify number in range [1:100000000].\n", argv[1]);
+    return 1;
+  }
+
+  if (nIter < 3 || nIter > 1000) {
+    fprintf(stderr, "Bad argument nIter='%s'. Please specify number in range [3:1000].\n", argv[2]);
+    return 1;
+  }
+  nIter |= 1; // use odd number of iterations
+
+  static const struct {
+    const char* name;
+    bid128_op3_fn op;
+    const bid128_test_vector_t* vec;
+    int nVec;
+  } vectors_tab[] = {
+    { "Bid128Mul", mul_op3,   bid128_mul_vectors, int(sizeof(bid128_mul_vectors)/sizeof(bid128_mul_vectors[0])) },
+    { "Bid128Fma", Bid128Fma, bid128_fma_vectors, int(sizeof(bid128_fma_vectors)/sizeof(bid128_fma_vectors[0])) },
+    { "Bid128Add", add_op3,   bid128_add_vectors, int(sizeof(bid128_add_vectors)/sizeof(bid128_add_vectors[0])) },
+    { "Bid128Sub", sub_op3,   bid128_sub_vectors, int(sizeof(bid128_sub_vectors)/sizeof(bid128_sub_vectors[0])) },
+  };
+  for (unsigned i = 0; i < sizeof(vectors_tab)/sizeof(vectors_tab[0]); ++i) {
+    if (!vectors_test(vectors_tab[i].name, vectors_tab[i].op, vectors_tab[i].vec, vectors_tab[i].nVec))
+      return 1;
+  }
+  if (!str_test())
+    return 1;
+  if (!parse_test())
+    return 1;
+  printf("o.k.\n");
+
+  time_test(nInps, nIter);
+  format_time_test(nInps, nIter);
+  parse_time_test(nInps, nIter);
+  return 0;
+}
+
+static bool vectors_test(const char* name, bid128_op3_fn op, const bid128_test_vector_t* vec, int nVec)
+{
+  for (int i = 0; i < nVec; ++i) {
+    for (unsigned rnd_mode = 0; rnd_mode < 5; ++rnd_mode) {
+      uint64_t res[2];
+      unsigned flags = 0;
+      op(res, vec[i].x, vec[i].y, vec[i].z, rnd_mode, &flags);
+      if (res[0] != vec[i].res[rnd_mode][0] || res[1] != vec[i].res[rnd_mode][1] || flags != vec[i].flags[rnd_mode]) {
+        printf(
+          "%s fail at vector %d.\n"
+          "x   = %016llx:%016llx\n"
+          "y   = %016llx:%016llx\n"
+          "z   = %016llx:%016llx\n"
+          "rnd = %u\n"
+          "res = %016llx:%016llx flags=%02x\n"
+          "exp = %016llx:%016llx flags=%02x\n"
+          , name, i
+          , (unsigned long long)vec[i].x[1], (unsigned long long)vec[i].x[0]
+          , (unsigned long long)vec[i].y[1], (unsigned long long)vec[i].y[0]
+          , (unsigned long long)vec[i].z[1], (unsigned long long)vec[i].z[0]
+          , rnd_mode
+          , (unsigned long long)res[1], (unsigned long long)res[0], flags
+          , (unsigned long long)vec[i].res[rnd_mode][1], (unsigned long long)vec[i].res[rnd_mode][0], vec[i].flags[rnd_mode]
+          );
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static bool str_test()
+{
+  const int nVec = int(sizeof(bid128_str_vectors)/sizeof(bid128_str_vectors[0]));
+  for (int i = 0; i < nVec; ++i) {
+    char str[BID128_STRING_MAX];
+    int len = Bid128ToString(str, bid128_str_vectors[i].x);
+    if (strcmp(str, bid128_str_vectors[i].str) != 0 || len != int(strlen(str))) {
+      printf(
+        "Bid128ToString fail at vector %d.\n"
+        "x   = %016llx:%016llx\n"
+        "res = %s (len=%d)\n"
+        "exp = %s\n"
+        , i
+        , (unsigned long long)bid128_str_vectors[i].x[1], (unsigned long long)bid128_str_vectors[i].x[0]
+        , str, len
+        , bid128_str_vectors[i].str
+        );
+      return false;
+    }
+  }
+
+  // exponents of every length, 1.2E+2 .. 1.2E+1001 and 1.2E-9 .. 1.2E-1999
+  static const struct {
+    int q; // exponent of coefficient 12
+    const char* str;
+  } exp_tab[] = {
+    {    1, "1.2E+2"    }, {    10, "1.2E+11"  }, {  100, "1.2E+101" }, {  1000, "1.2E+1001" },
+    {  -10, "1.2E-9"    }, {   -20, "1.2E-19"  }, { -200, "1.2E-199" }, { -2000, "1.2E-1999" },
+  };
+  for (unsigned i = 0; i < sizeof(exp_tab)/sizeof(exp_tab[0]); ++i) {
+    const uint64_t x[2] = { 12, uint64_t(exp_tab[i].q + 6176) << 49 }; // biased exponent
+    char str[BID128_STRING_MAX];
+    int len = Bid128ToString(str, x);
+    if (strcmp(str, exp_tab[i].str) != 0 || len != int(strlen(str))) {
+      printf(
+        "Bid128ToString fail at exponent %d.\n"
+        "res = %s (len=%d)\n"
+        "exp = %s\n"
+        , exp_tab[i].q + 1
+        , str, len
+        , exp_tab[i].str
+        );
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool parse_test()
+{
+  const int nVec = int(sizeof(bid128_parse_vectors)/sizeof(bid128_parse_vectors[0]));
+  for (int i = 0; i < nVec; ++i) {
+    const bid128_parse_vector_t& v = bid128_parse_vectors[i];
+    const size_t len = strlen(v.str);
+    for (unsigned rnd_mode = 0; rnd_mode < 5; ++rnd_mode) {
+      uint64_t res[2];
+      unsigned flags = 0;
+      size_t nc = Bid128FromString(res, v.str, len, rnd_mode, &flags);
+      bool ok;
+      if (nc == len)
+        ok = res[0] == v.res[rnd_mode][0] && res[1] == v.res[rnd_mode][1] && flags == v.flags[rnd_mode];
+      else // only a prefix is a number, the whole string must be a syntax error
+        ok = v.res[rnd_mode][0] == 0 && v.res[rnd_mode][1] == ((uint64_t)0x1F << 58) && v.flags[rnd_mode] == BID_INVALID_EXCEPTION;
+      if (!ok) {
+        printf(
+          "Bid128FromString fail at vector %d.\n"
+          "str = \"%s\"\n"
+          "rnd = %u\n"
+          "res = %016llx:%016llx flags=%02x, %d characters consumed\n"
+          "exp = %016llx:%016llx flags=%02x\n"
+          , i, v.str, rnd_mode
+          , (unsigned long long)res[1], (unsigned long long)res[0], flags, int(nc)
+          , (unsigned long long)v.res[rnd_mode][1], (unsigned long long)v.res[rnd_mode][0], v.flags[rnd_mode]
+          );
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// random finite decimal128 with 34-digit coefficient and exponent in range [-64:63]
+static void rnd_bid128(uint64_t x[2], std::mt19937_64& rndGen)
+{
+  static const mp_uint128_t POW10_33(0xb34b9f1000000000ull, 0x00000314dc6448d9ull);
+  mp_uint128_t range = POW10_33;
+  range *= 9;
+  mp_uint128_t c = mulu(range, mp_uint128_t(rndGen(), rndGen())); // [0:9*10**33-1]
+  c += POW10_33;
+  uint64_t w = rndGen();
+  unsigned exp = 6176 - 64 + (w & 127);
+  x[0] = c.w[0];
+  x[1] = (w & ((uint64_t)1 << 63)) | ((uint64_t)exp << 49) | c.w[1];
+}
+
+// median time of nIter runs of body(i) for i in [0:nInps), microseconds
+template <typename Body>
+static int64_t median_time(int nInps, int nIter, Body body)
+{
+  std::vector<int64_t> tmVec(nIter);
+  for (int it = 0; it < nIter; ++it) {
+    std::chrono::steady_clock::time_point hres_t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < nInps; ++i)
+      body(i);
+    std::chrono::steady_clock::time_point hres_t1 = std::chrono::steady_clock::now();
+    tmVec[it] = std::chrono::duration_cast<std::chrono::microseconds>(hres_t1 - hres_t0).count();
+  }
+  std::nth_element(tmVec.begin(), tmVec.begin()+(nIter/2), tmVec.end());
+  return tmVec[nIter/2];
+}
+
+static void print_time(const char* name, int64_t tmMed, int nInps)
+{
+  printf("%-16s: %8.0f usec. %7.2f Mops/s\n", name, double(tmMed), tmMed > 0 ? double(nInps)/tmMed : 0.0);
+}
+
+static void time_test(int nInps, int nIter)
+{
+  std::mt19937_64 rndGen;
+  std::vector<uint64_t> xv(nInps*2), yv(nInps*2), zv(nInps*2);
+  for (int i = 0; i < nInps; ++i) {
+    rnd_bid128(&xv[i*2], rndGen);
+    rnd_bid128(&yv[i*2], rndGen);
+    rnd_bid128(&zv[i*2], rndGen);
+    // scale z to the magnitude of the product, so both contribute to the sum
+    unsigned ez = ((xv[i*2+1] >> 49 & 0x3FFF) + (yv[i*2+1] >> 49 & 0x3FFF) - 6176 + 34 + (zv[i*2] & 7)) - 4;
+    zv[i*2+1] = (zv[i*2+1] & ~((uint64_t)0x3FFF << 49)) | ((uint64_t)ez << 49);
+  }
+
+  uint64_t dummy = 0;
+  unsigned flags = 0;
+  int64_t tm;
+  tm = median_time(nInps, nIter, [&](int i) {
+    uint64_t r[2];
+    Bid128Mul(r, &xv[i*2], &yv[i*2], BID_ROUND_NEAREST_EVEN, &flags);
+    dummy ^= r[0] ^ r[1];
+  });
+  print_time("Bid128Mul", tm, nInps);
+
+  tm = median_time(nInps, nIter, [&](int i) {
+    uint64_t r[2];
+    Bid128Fma(r, &xv[i*2], &yv[i*2], &zv[i*2], BID_ROUND_NEAREST_EVEN, &flags);
+    dummy ^= r[0] ^ r[1];
+  });
+  print_time("Bid128Fma", tm, nInps);
+
+  tm = median_time(nInps, nIter, [&](int i) {
+    uint64_t p[2], r[2];
+    Bid128Mul(p, &xv[i*2], &yv[i*2], BID_ROUND_NEAREST_EVEN, &flags);
+    Bid128Add(r, p, &zv[i*2], BID_ROUND_NEAREST_EVEN, &flags);
+    dummy ^= r[0] ^ r[1];
+  });
+  print_time("Bid128Mul+Add", tm, nInps);
+
+  // Addition, exponent difference drawn from different distributions
+  static const struct {
+    const char* name;
+    int         type;
+  } ediff_tab[] = {
+    { "Add ediff=0",     0 }, // the same exponent, e.g. amounts in the same currency
+    { "Add ediff~geom",  1 }, // P(ediff=k) = 2**-(k+1)
+    { "Add ediff=1-33",  2 }, // uniform, partial overlap
+    { "Add ediff=40-99", 3 }, // far apart, sticky only
+  };
+  std::vector<uint64_t> av(nInps*2);
+  for (unsigned di = 0; di < sizeof(ediff_tab)/sizeof(ediff_tab[0]); ++di) {
+    for (int i = 0; i < nInps; ++i) {
+      uint64_t w = rndGen();
+      int ediff = 0;
+      switch (ediff_tab[di].type) {
+        case 1: while (ediff < 63 && (w >> ediff & 1)) ++ediff; break;
+        case 2: ediff = 1 + int((w & 0xFFFFFFFF)*33 >> 32); break;
+        case 3: ediff = 40 + int((w & 0xFFFFFFFF)*60 >> 32); break;
+      }
+      if (w >> 63)
+        ediff = -ediff;
+      unsigned ey = (xv[i*2+1] >> 49 & 0x3FFF) + ediff;
+      av[i*2+0] = yv[i*2+0];
+      av[i*2+1] = (yv[i*2+1] & ~((uint64_t)0x3FFF << 49)) | ((uint64_t)ey << 49);
+    }
+    tm = median_time(nInps, nIter, [&](int i) {
+      uint64_t r[2];
+      Bid128Add(r, &xv[i*2], &av[i*2], BID_ROUND_NEAREST_EVEN, &flags);
+      dummy ^= r[0] ^ r[1];
+    });
+    print_time(ediff_tab[di].name, tm, nInps);
+  }
+
+  if (dummy == 42 && flags == 42)
+    printf("Blue moon\n");
+}
+
+static void print_time_ns(const char* name, int64_t tmMed, int nInps)
+{
+  printf("%-16s: %8.0f usec. %7.2f ns/value\n", name, double(tmMed), double(tmMed)*1e3/nInps);
+}
+
+#ifdef __SIZEOF_INT128__
+// baseline: coefficient printed by snprintf in 19-digit halves, split by 128-bit integer division
+static int snprintf_bid128(char* str, size_t size, const uint64_t x[2])
+{
+  const unsigned __int128 c = ((unsigned __int128)(x[1] & (((uint64_t)1 << 49) - 1)) << 64) | x[0];
+  const int e = int(x[1] >> 49 & 0x3FFF) - 6176;
+  const char* sign = (x[1] >> 63) ? "-" : "";
+  const uint64_t POW10_19 = 10000000000000000000ull;
+  if (c >= POW10_19)
+    return snprintf(str, size, "%s%llu%019lluE%+d", sign, (unsigned long long)(c / POW10_19), (unsigned long long)(c % POW10_19), e);
+  return snprintf(str, size, "%s%lluE%+d", sign, (unsigned long long)c, e);
+}
+#endif
+
+static void format_time_test(int nInps, int nIter)
+{
+  std::mt19937_64 rndGen(2);
+  std::vector<uint64_t> xv(nInps*2), pv(nInps*2);
+  for (int i = 0; i < nInps; ++i) {
+    rnd_bid128(&xv[i*2], rndGen);
+    // price-like: up to 10 digits, 2 to 8 digits after decimal point
+    uint64_t w = rndGen();
+    pv[i*2+0] = (w & 0xFFFFFFFFFF) % 10000000000ull;
+    pv[i*2+1] = (uint64_t)(6176 - 2 - (w >> 40) % 7) << 49;
+  }
+
+  static const struct {
+    const char* name;
+    const std::vector<uint64_t>* inp;
+  } inp_tab[] = {
+    { "34dig", &xv },
+    { "price",     &pv },
+  };
+  uint64_t dummy = 0;
+  for (unsigned k = 0; k < sizeof(inp_tab)/sizeof(inp_tab[0]); ++k) {
+    const uint64_t* inp = inp_tab[k].inp->data();
+    char name[64];
+    int64_t tm = median_time(nInps, nIter, [&](int i) {
+      char str[BID128_STRING_MAX];
+      dummy += Bid128ToString(str, &inp[i*2]);
+      dummy += str[2];
+    });
+    snprintf(name, sizeof(name), "ToString %s", inp_tab[k].name);
+    print_time_ns(name, tm, nInps);
+#ifdef __SIZEOF_INT128__
+    tm = median_time(nInps, nIter, [&](int i) {
+      char str[BID128_STRING_MAX];
+      dummy += snprintf_bid128(str, sizeof(str), &inp[i*2]);
+      dummy += str[2];
+    });
+    snprintf(name, sizeof(name), "snprintf %s", inp_tab[k].name);
+    print_time_ns(name, tm, nInps);
+#endif
+  }
+
+  if (dummy == 42)
+    printf("Blue moon\n");
+}
+
+// parse newline-separated corpus of numbers in different formats
+static void parse_time_test(int nInps, int nIter)
+{
+  std::mt19937_64 rndGen(3);
+  static const struct {
+    const char* name;
+    int         type;
+  } corpus_tab[] = {
+    { "Parse 34dig",  0 }, // output of Bid128ToString
+    { "Parse price",  1 }, // up to 10 digits, 2 to 8 digits after decimal point
+    { "Parse 35-68",  2 }, // 35 to 68 digits, rounded
+  };
+  for (unsigned k = 0; k < sizeof(corpus_tab)/sizeof(corpus_tab[0]); ++k) {
+    std::string corpus;
+    for (int i = 0; i < nInps; ++i) {
+      char str[BID128_STRING_MAX + 40];
+      uint64_t x[2];
+      switch (corpus_tab[k].type) {
+        case 0:
+          rnd_bid128(x, rndGen);
+          Bid128ToString(str, x);
+          break;
+        case 1: {
+          uint64_t w = rndGen();
+          int nf = 2 + int((w >> 40) % 7);
+          unsigned long long c = (w & 0xFFFFFFFFFF) % 10000000000ull;
+          snprintf(str, sizeof(str), "%llu.%0*llu", c / 100000000, nf, c % 100000000 % (unsigned long long)std::pow(10, nf));
+          break;
+        }
+        default: {
+          int nd = 35 + int(rndGen() % 34);
+          for (int j = 0; j < nd; ++j)
+            str[j] = char('0' + (j == 0 ? 1 + rndGen() % 9 : rndGen() % 10));
+          snprintf(str + nd, sizeof(str) - nd, "E-%d", int(rndGen() % 100));
+          break;
+        }
+      }
+      corpus += str;
+      corpus += '\n';
+    }
+
+    uint64_t dummy = 0;
+    unsigned flags = 0;
+    int64_t tm = median_time(1, nIter, [&](int) {
+      const char* p = corpus.data();
+      const char* end = p + corpus.size();
+      while (p < end) {
+        uint64_t r[2];
+        p += Bid128FromString(r, p, end - p, BID_ROUND_NEAREST_EVEN, &flags) + 1;
+        dummy ^= r[0] ^ r[1];
+      }
+    });
+    printf("%-16s: %8.0f usec. %7.2f ns/value %6.3f GB/s\n", corpus_tab[k].name, double(tm), double(tm)*1e3/nInps,
+      tm > 0 ? double(corpus.size())/tm*1e-3 : 0.0);
+    if (dummy == 42 && flags == 42)
+      printf("Blue moon\n");
+  }
+}
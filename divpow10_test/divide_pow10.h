@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <stddef.h>
 #define REPORT_UNDERFLOWS 0
 
 // DivideDecimal68ByPowerOf10 - Divide unsigned integer number by power of ten
@@ -18,6 +19,193 @@
 //    in a sense that it causes no memory corruptions, traps or any other undefined actions
 int DivideDecimal68ByPowerOf10(uint64_t result[2], const uint64_t src[4], unsigned n);
 
+// DivModDecimal68ByPowerOf10 - Divide unsigned integer number by power of ten, with remainder
+//
+// Arguments:
+// result    - result of division, the same as in DivideDecimal68ByPowerOf10
+// remainder - src - result*10**n, 2 64-bit words, range [0:10**n-1], Little Endian
+// src       - source (dividend), the same as in DivideDecimal68ByPowerOf10
+// n         - decimal exponent of the divisor, range 0 to 34. For n out of range remainder=0.
+// Return value: the same as DivideDecimal68ByPowerOf10
+//
+// Comments:
+// The remainder is assembled from values the division computes anyway, it costs 2 or 3 multiplications
+// and no extra table lookups
+int DivModDecimal68ByPowerOf10(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n);
+
+// DivideDecimal68ByPowerOf10_x2 - Divide two independent unsigned integer numbers by powers of ten
+//
+// Arguments:
+// result - results of division, the same format as result of DivideDecimal68ByPowerOf10
+// ret    - rounding codes, the same as return value of DivideDecimal68ByPowerOf10
+// src    - sources (dividends), the same format as src of DivideDecimal68ByPowerOf10
+// n      - decimal exponents of divisors, each in range 0 to 34
+//
+// Comments:
+// 1. Every lane produces the same result and rounding code as DivideDecimal68ByPowerOf10(result[i], src[i], n[i])
+// 2. Scalar code, not SIMD. When all n are in range 1 to 34 the lanes are one basic block without branches,
+//    where every step is done for all lanes before the next one: both table rows are loaded first, then
+//    the multiplications of the lanes alternate. Otherwise lanes are divided one by one.
+// 3. It pays off where the caller waits for the results, i.e. when a chain of divisions is latency-bound:
+//    4096 calls with random n, next src depends on the previous results, best of 300 runs on Xeon:
+//    single 17.1 ns/div, x2 10.6-11.0 ns/div, x4 8.0-8.4 ns/div. In a throughput loop of independent calls
+//    the out-of-order core already overlaps consecutive calls, and x2/x4 are within 3% of single calls
+//    (6.7 ns/div), sometimes slower.
+void DivideDecimal68ByPowerOf10_x2(uint64_t result[2][2], int ret[2], const uint64_t src[2][4], const unsigned n[2]);
+
+// DivideDecimal68ByPowerOf10_x4 - Divide four independent unsigned integer numbers by powers of ten
+// The same as DivideDecimal68ByPowerOf10_x2, for 4 lanes
+void DivideDecimal68ByPowerOf10_x4(uint64_t result[4][2], int ret[4], const uint64_t src[4][4], const unsigned n[4]);
+
+enum { DIVPOW10_32_NMAX = 16 };
+
+// DivideDecimal32ByPowerOf10 - Divide 128-bit unsigned integer number by power of ten
+//
+// Arguments:
+// result - result of division, 1 64-bit word, range [0:10**16-1]
+// src    - source (dividend), 2 64-bit words, range [0:10**32-1], Little Endian
+// n      - decimal exponent of the divisor, i.e. divisor=10**n, range 0 to 16. For n=0 result=src[0].
+// Return value: the same as DivideDecimal68ByPowerOf10
+//
+// Comments:
+// 1. Sibling of DivideDecimal68ByPowerOf10 for decimal64, where product of two coefficients fits into 128 bits.
+//    It costs one 64x64->128 multiplication and one 64x64->64 multiplication.
+// 2. When src >= 10**n * 2**56 the results are incorrect, but the call is still legal
+//    in a sense that it causes no memory corruptions, traps or any other undefined actions
+int DivideDecimal32ByPowerOf10(uint64_t* result, const uint64_t src[2], unsigned n);
+
+enum { // rounding modes of DivideRoundDecimal68ByPowerOf10, the same values as in Intel Decimal Floating-Point Math Library
+  DIVPOW10_ROUND_NEAREST_EVEN = 0,
+  DIVPOW10_ROUND_DOWN         = 1, // toward -Inf
+  DIVPOW10_ROUND_UP           = 2, // toward +Inf
+  DIVPOW10_ROUND_ZERO         = 3, // toward zero
+  DIVPOW10_ROUND_NEAREST_AWAY = 4,
+};
+
+// divpow10_round_inc_tab - rounding increment for each of DIVPOW10_ROUND_xxx, bit index = code | odd << 2 | sign << 3,
+// where code is the return value of DivideDecimal68ByPowerOf10 and odd is LS bit of the quotient.
+// Defined in divide_pow10_round.c, 8 entries, so that rnd_mode & 7 is always a valid index.
+extern const uint16_t divpow10_round_inc_tab[8];
+
+// DivideRoundDecimal68ByPowerOf10 - Divide unsigned integer number by power of ten and round the quotient
+//
+// Arguments:
+// result   - rounded result of division, 2 64-bit words, range [0:10**34-1], Little Endian
+// src      - source (dividend), the same as in DivideDecimal68ByPowerOf10
+// n        - decimal exponent of the divisor, the same as in DivideDecimal68ByPowerOf10
+// rnd_mode - one of DIVPOW10_ROUND_xxx, other values round toward zero
+// sign     - sign of the value, 0 or 1, it matters only for DIVPOW10_ROUND_DOWN and DIVPOW10_ROUND_UP
+// exp_adj  - 1 when rounding carried the result to 10**34 and it was replaced by 10**33, otherwise 0
+// Return value: 1 when the result is inexact, i.e. remainder of division > 0, otherwise 0
+//
+// Comments:
+// 1. The increment is a bit of a 16-bit mask of the rounding mode, selected by rounding code, parity of
+//    the quotient and sign. Neither the increment nor renormalization use data-dependent branches.
+// 2. Range of src is the same as in DivideDecimal68ByPowerOf10
+int DivideRoundDecimal68ByPowerOf10(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned rnd_mode, unsigned sign, int* exp_adj);
+
+// RoundDecimal68ToDigits - Round unsigned integer number to at most p decimal digits
+//
+// Arguments:
+// result    - rounded coefficient, 2 64-bit words, range [0:10**p-1], Little Endian
+// src       - source, 4 64-bit words, range [0:10**68-1], Little Endian, e.g. product of two decimal128 coefficients
+// p         - precision, range 1 to 34, e.g. 34 for decimal128 or 16 for decimal64. Other values are treated as 34.
+// rnd_mode  - one of DIVPOW10_ROUND_xxx, other values round toward zero
+// sign      - sign of the value, 0 or 1, it matters only for DIVPOW10_ROUND_DOWN and DIVPOW10_ROUND_UP
+// n_dropped - number of dropped digits, i.e. src is approximately result * 10**(*n_dropped)
+// Return value: 1 when the result is inexact, otherwise 0
+//
+// Comments:
+// 1. The same as counting digits d of src and calling DivideRoundDecimal68ByPowerOf10 with n=max(d-p,0),
+//    except that rounding carry to 10**p is renormalized to 10**(p-1) for any p.
+// 2. Digit count takes bit length, a byte table lookup and one 256-bit comparison, without branches on data.
+//    When d > 34+p, that is possible only for p < 34, src is divided in two steps.
+int RoundDecimal68ToDigits(uint64_t result[2], const uint64_t src[4], unsigned p, unsigned rnd_mode, unsigned sign, unsigned* n_dropped);
+
+// divpow10_pow10_tab - powers of ten 10**0 to 10**68, 4 64-bit words each, Little Endian, generated by mk_tab_round.py
+extern const uint64_t divpow10_pow10_tab[69][4];
+
+// DivideDecimal68ByPowerOf10_Batch - Divide array of unsigned integer numbers by powers of ten
+//
+// Arguments:
+// result - results of division, count elements, same format as result of DivideDecimal68ByPowerOf10
+// ret    - rounding codes, count elements, same as return value of DivideDecimal68ByPowerOf10
+// src    - sources (dividends), count elements, same format as src of DivideDecimal68ByPowerOf10
+// n      - decimal exponents of divisors, count elements, each in range 0 to 34
+// count  - number of elements
+//
+// Comments:
+// 1. Every element produces the same result and return value as DivideDecimal68ByPowerOf10(result[i], src[i], n[i])
+//    as long as src[i] < 10**n[i] * 2**112
+// 2. On CPUs with AVX512-IFMA elements are processed 8 at time, otherwise it falls back to scalar code
+void DivideDecimal68ByPowerOf10_Batch(uint64_t result[][2], int ret[], const uint64_t src[][4], const unsigned n[], size_t count);
+
+// DivideDecimal68ByPowerOf10_Bucketed - Divide array of unsigned integer numbers by powers of ten, grouped by exponent
+//
+// Arguments: the same as in DivideDecimal68ByPowerOf10_Batch
+//
+// Comments:
+// 1. Every element produces the same result and return value as DivideDecimal68ByPowerOf10(result[i], src[i], n[i])
+// 2. Elements are taken in chunks of up to 1024. Indices of a chunk are sorted by n with a counting sort over
+//    the 35 exponent values, then every group runs a loop of the kernel of DivideDecimal68ByPowerOf10_opt for its n,
+//    with reciprocal, shifts and branches on n folded into the code, and results are stored at the original positions.
+// 3. It removes the per-call dispatch on n of DivideDecimal68ByPowerOf10_opt, that mispredicts under mixed n,
+//    and is 1.25-2.5x faster than a loop of DivideDecimal68ByPowerOf10_opt. The branch-free DivideDecimal68ByPowerOf10
+//    has nothing of the kind to remove: the constant-n kernel saves about 1.5 ns per element, the sort and the access
+//    to elements in the order of n cost 2-3 ns. So with random n Bucketed runs at 0.80-0.87x of a plain loop
+//    of DivideDecimal68ByPowerOf10, i.e. it is slower. bucket_time_test in main.cpp measures it for every n range.
+void DivideDecimal68ByPowerOf10_Bucketed(uint64_t result[][2], int ret[], const uint64_t src[][4], const unsigned n[], size_t count);
+
+// DivideDecimal68ByPowerOf10_Column - Divide column of unsigned integer numbers by the same power of ten
+//
+// Arguments:
+// result - results of division as 2 word planes, result[k][i] = word k of i-th quotient
+// ret    - rounding codes, count elements, same as return value of DivideDecimal68ByPowerOf10
+// src    - sources (dividends) as 4 word planes, src[k][i] = word k of i-th dividend
+// n      - decimal exponent of the divisor, the same for all elements, range 0 to 34
+// count  - number of elements
+//
+// Comments:
+// 1. Every element produces the same result and return value as DivideDecimal68ByPowerOf10()
+// 2. On CPUs with AVX2 elements are processed 4 at time, otherwise it falls back to scalar code
+void DivideDecimal68ByPowerOf10_Column(uint64_t* const result[2], int ret[], const uint64_t* const src[4], unsigned n, size_t count);
+
+// Trace file of DivideDecimal68ByPowerOf10_Traced: DIVPOW10_TRACE_HDR_SIZE bytes of header, that starts with
+// DIVPOW10_TRACE_MAGIC followed by record size byte, then DIVPOW10_TRACE_REC_SIZE-byte records, Little Endian.
+// Record is src[4] of the call with n in the upper byte of src[3], so src = rec & (2**248-1), n = rec >> 248.
+#define DIVPOW10_TRACE_MAGIC "DP10TRC1"
+enum { DIVPOW10_TRACE_HDR_SIZE = 16, DIVPOW10_TRACE_REC_SIZE = 32 };
+
+// DivPow10_TraceOpen - Create trace file and start recording of DivideDecimal68ByPowerOf10_Traced calls
+//
+// Arguments:
+// fname - name of the trace file, existing file is overwritten
+// Return value: 1 on success, 0 when file can't be created
+//
+// Comments:
+// Open and close may be called while other threads call DivideDecimal68ByPowerOf10_Traced.
+// Records are buffered per thread, a thread that stops calling DivideDecimal68ByPowerOf10_Traced before
+// DivPow10_TraceClose has to call DivPow10_TraceFlush, or its last records are lost. Records, buffered by
+// other threads when the trace is closed, are dropped, they are never written to the next trace.
+int DivPow10_TraceOpen(const char* fname);
+
+// DivPow10_TraceFlush - Write records, buffered by the calling thread, to the trace file
+void DivPow10_TraceFlush(void);
+
+// DivPow10_TraceClose - Flush buffer of the calling thread and close the trace file
+void DivPow10_TraceClose(void);
+
+// DivideDecimal68ByPowerOf10_Traced - DivideDecimal68ByPowerOf10 that records its arguments
+//
+// Arguments and return value: the same as DivideDecimal68ByPowerOf10
+//
+// Comments:
+// 1. While trace file is open, (src, n) of every call is appended to the trace file. Nothing but the
+//    arguments is recorded. Calls with src >= 2**248 are out of contract of DivideDecimal68ByPowerOf10 and
+//    are not recorded.
+// 2. When no trace file is open the overhead is one load and one predictable branch
+int DivideDecimal68ByPowerOf10_Traced(uint64_t result[2], const uint64_t src[4], unsigned n);
+
 #if REPORT_UNDERFLOWS
 extern uint8_t gl_underflow;
 #endif
\ No newline at end of file
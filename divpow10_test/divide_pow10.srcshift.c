@@ -1,4 +1,6 @@
 #include "divide_pow10.h"
+#include "divide_pow10_variants.h"
+#include "divide_pow10_cpu.h"
 #include <string.h>
 
 #ifndef _MSC_VER
@@ -7,24 +9,56 @@ static inline uint64_t __umulh(uint64_t a, uint64_t b) {
 }
 #endif
 
-// DivideDecimal68ByPowerOf10 - Divide unsigned integer number by power of ten
-//
-// Arguments:
-// result - result of division, 2 64-bit words, range [0:10**34-1], Little Endian
-// src    - source (dividend), 4 64-bit words, range [0:10**68-1], Little Endian
-// n      - decimal exponent of the divisor, i.e. divisor=10**n, range 0 to 34
-// Return value:  0 when remainder of division ==0
-//                1 when remainder of division >0 and < divisor/2,
-//                2 when remainder == divisor/2,
-//                3 when remainder > divisor/2
-//
-// Comments:
-// 1. It works only on Little Endian machines with sizeof(uint32_t)*2=sizeof(uint64_t)
-// 2. When src >= 10**n * 2**112 the results are incorrect, but the call is still legal
-//    in a sense that it causes no memory corruptions, traps or any other undefined actions
-int DivideDecimal68ByPowerOf10(uint64_t result[2], const uint64_t src[4], unsigned n)
+// divide_srcshift - common body of DivideDecimal68ByPowerOf10_srcshift and DivModDecimal68ByPowerOf10_srcshift
+// remainder=0 when the caller does not need it
+static DIVPOW10_FORCEINLINE int divide_srcshift(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n)
 {
   enum { DIV1_NMAX = 4, NMAX = 34 };
+  // Rows are 32 bytes, the table is aligned to cache line, so one division reads one line
+  // Rows 1 to DIV1_NMAX: invF = 2**130 / mulF, mulF_h = 0, nb = 0
+  // Other rows: invF = 2**(nb+64*3+13) / mulF, nb = maximal number of bits in src[] - 64*k, where k=2 or 3
+  DIVPOW10_CACHE_ALIGNED static const struct {
+    uint64_t mulF_l;  // 10**n / 2
+    uint64_t mulF_hx; // mulF_h | nb << 56, mulF_h < 2**48
+    uint64_t invF_l;
+    uint64_t invF_h;
+  } recip_tab[NMAX] = {
+   {0x0000000000000005, 0x0000000000000000, 0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCC }, //  1
+   {0x0000000000000032, 0x0000000000000000, 0x47AE147AE147AE14, 0x147AE147AE147AE1 }, //  2
+   {0x00000000000001F4, 0x0000000000000000, 0xED916872B020C49B, 0x020C49BA5E353F7C }, //  3
+   {0x0000000000001388, 0x0000000000000000, 0x4AF4F0D844D013A9, 0x00346DC5D6388659 }, //  4
+   {0x000000000000C350, 0x0200000000000000, 0x0FCF80DC33721D53, 0xA7C5AC471B478423 }, //  5 (nb = 130 % 64)
+   {0x000000000007A120, 0x0500000000000000, 0xA63F9A49C2C1B10F, 0x8637BD05AF6C69B5 }, //  6 (nb = 133 % 64)
+   {0x00000000004C4B40, 0x0900000000000000, 0x3D32907604691B4C, 0xD6BF94D5E57A42BC }, //  7 (nb = 137 % 64)
+   {0x0000000002FAF080, 0x0C00000000000000, 0xFDC20D2B36BA7C3D, 0xABCC77118461CEFC }, //  8 (nb = 140 % 64)
+   {0x000000001DCD6500, 0x0F00000000000000, 0x31680A88F8953030, 0x89705F4136B4A597 }, //  9 (nb = 143 % 64)
+   {0x000000012A05F200, 0x1300000000000000, 0xB573440E5A884D1B, 0xDBE6FECEBDEDD5BE }, // 10 (nb = 147 % 64)
+   {0x0000000BA43B7400, 0x1600000000000000, 0xF78F69A51539D748, 0xAFEBFF0BCB24AAFE }, // 11 (nb = 150 % 64)
+   {0x000000746A528800, 0x1900000000000000, 0xF93F87B7442E45D3, 0x8CBCCC096F5088CB }, // 12 (nb = 153 % 64)
+   {0x0000048C27395000, 0x1D00000000000000, 0x2865A5F206B06FB9, 0xE12E13424BB40E13 }, // 13 (nb = 157 % 64)
+   {0x00002D79883D2000, 0x2000000000000000, 0x538484C19EF38C94, 0xB424DC35095CD80F }, // 14 (nb = 160 % 64)
+   {0x0001C6BF52634000, 0x2300000000000000, 0x0F9D37014BF60A10, 0x901D7CF73AB0ACD9 }, // 15 (nb = 163 % 64)
+   {0x0011C37937E08000, 0x2700000000000000, 0x4C2EBE687989A9B3, 0xE69594BEC44DE15B }, // 16 (nb = 167 % 64)
+   {0x00B1A2BC2EC50000, 0x2A00000000000000, 0x09BEFEB9FAD487C2, 0xB877AA3236A4B449 }, // 17 (nb = 170 % 64)
+   {0x06F05B59D3B20000, 0x2D00000000000000, 0x3AFF322E62439FCF, 0x9392EE8E921D5D07 }, // 18 (nb = 173 % 64)
+   {0x4563918244F40000, 0x3100000000000000, 0x2B31E9E3D06C32E5, 0xEC1E4A7DB69561A5 }, // 19 (nb = 177 % 64)
+   {0xB5E3AF16B1880000, 0x3400000000000002, 0x88F4BB1CA6BCF584, 0xBCE5086492111AEA }, // 20 (nb = 180 % 64)
+   {0x1AE4D6E2EF500000, 0x370000000000001B, 0xD3F6FC16EBCA5E03, 0x971DA05074DA7BEE }, // 21 (nb = 183 % 64)
+   {0x0CF064DD59200000, 0x3B0000000000010F, 0x5324C68B12DD6338, 0xF1C90080BAF72CB1 }, // 22 (nb = 187 % 64)
+   {0x8163F0A57B400000, 0x3E00000000000A96, 0x75B7053C0F178293, 0xC16D9A0095928A27 }, // 23 (nb = 190 % 64)
+   {0x0DE76676D0800000, 0x01000000000069E1, 0xC4926A9672793542, 0x9ABE14CD44753B52 }, // 24 (nb = 193 % 64)
+   {0x8B0A00A425000000, 0x04000000000422CA, 0x9D41EEDEC1FA9102, 0x7BCB43D769F762A8 }, // 25 (nb = 196 % 64)
+   {0x6E64066972000000, 0x0800000000295BE9, 0x95364AFE032A819D, 0xC612062576589DDA }, // 26 (nb = 200 % 64)
+   {0x4FE8401E74000000, 0x0B000000019D971E, 0x775EA264CF55347D, 0x9E74D1B791E07E48 }, // 27 (nb = 203 % 64)
+   {0x1F12813088000000, 0x0E0000001027E72F, 0xC5E54EB70C4429FE, 0x7EC3DAF941806506 }, // 28 (nb = 206 % 64)
+   {0x36B90BE550000000, 0x12000000A18F07D7, 0x096EE45813A04330, 0xCAD2F7F5359A3B3E }, // 29 (nb = 210 % 64)
+   {0x233A76F520000000, 0x150000064F964E68, 0xA1258379A94D028D, 0xA2425FF75E14FC31 }, // 30 (nb = 213 % 64)
+   {0x6048A59340000000, 0x1800003F1BDF1011, 0x80EACF948770CED7, 0x81CEB32C4B43FCF4 }, // 31 (nb = 216 % 64)
+   {0xC2D677C080000000, 0x1C00027716B6A0AD, 0x67DE18EDA5814AF2, 0xCFB11EAD453994BA }, // 32 (nb = 220 % 64)
+   {0x9C60AD8500000000, 0x1F0018A6E32246C9, 0xECB1AD8AEACDD58E, 0xA6274BBDD0FADD61 }, // 33 (nb = 223 % 64)
+   {0x1BC6C73200000000, 0x2200F684DF56C3E0, 0xBD5AF13BEF0B113E, 0x84EC3C97DA624AB4 }, // 34 (nb = 226 % 64)
+  };
+
   if (n <= DIV1_NMAX) {
     // 10**(n+34) < 2**128
     uint64_t src1 = src[1];
@@ -32,21 +66,13 @@ int DivideDecimal68ByPowerOf10(uint64_t result[2], const uint64_t src[4], unsign
     if (n==0) {
       result[1] = src1;
       result[0] = src0;
+      if (remainder)
+        remainder[0] = remainder[1] = 0;
       return 0;
     }
-    static const struct {
-      uint64_t mulF;    // 10**n / 2
-      uint64_t invF_l;  // 2**130 / mulF
-      uint64_t invF_h;
-    } recip_tab0[DIV1_NMAX] = {
-     {   10 / 2, 0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCC }, //  1
-     {  100 / 2, 0x47AE147AE147AE14, 0x147AE147AE147AE1 }, //  2
-     { 1000 / 2, 0xED916872B020C49B, 0x020C49BA5E353F7C }, //  3
-     {10000 / 2, 0x4AF4F0D844D013A9, 0x00346DC5D6388659 }, //  4
-    };
-    const uint64_t invF_h = recip_tab0[n-1].invF_h;
-    const uint64_t invF_l = recip_tab0[n-1].invF_l;
-    const uint64_t mulF   = recip_tab0[n-1].mulF;
+    const uint64_t invF_h = recip_tab[n-1].invF_h;
+    const uint64_t invF_l = recip_tab[n-1].invF_l;
+    const uint64_t mulF   = recip_tab[n-1].mulF_l;
 #ifndef _MSC_VER
     typedef unsigned __int128 uintex_t;
     uintex_t rx = (uintex_t)src1 * invF_h;
@@ -79,95 +105,34 @@ int DivideDecimal68ByPowerOf10(uint64_t result[2], const uint64_t src[4], unsign
     }
 #endif
     int steaky = rem != 0;
+    if (remainder) {
+      remainder[0] = rem + (mulF & (0 - (r0 & 1))); // r1:r0 is 2*quotient
+      remainder[1] = 0;
+    }
     result[0] = (r1 << 63) | (r0 >> 1);
     result[1] = r1 >> 1;
     return (r0*2 & 2) | steaky;
   }
 
-  if (n > NMAX)
+  if (n > NMAX) {
+    if (remainder)
+      remainder[0] = remainder[1] = 0;
     return 0; // should not happen
+  }
 
   // DIV1_NMAX < n <= NMAX
   // 10**n > 2**128
-  static const uint8_t nb_tab[NMAX-DIV1_NMAX] = { // maximal number of bits in src[] - 64*k, where k=2 or 3
-    130 % 64, //  5 ( 2)
-    133 % 64, //  6 ( 5)
-    137 % 64, //  7 ( 9)
-    140 % 64, //  8 (12)
-    143 % 64, //  9 (15)
-    147 % 64, // 10 (19)
-    150 % 64, // 11 (22)
-    153 % 64, // 12 (25)
-    157 % 64, // 13 (29)
-    160 % 64, // 14 (32)
-    163 % 64, // 15 (35)
-    167 % 64, // 16 (39)
-    170 % 64, // 17 (42)
-    173 % 64, // 18 (45)
-    177 % 64, // 19 (49)
-    180 % 64, // 20 (52)
-    183 % 64, // 21 (55)
-    187 % 64, // 22 (59)
-    190 % 64, // 23 (62)
-    193 % 64, // 24 ( 1)
-    196 % 64, // 25 ( 4)
-    200 % 64, // 26 ( 8)
-    203 % 64, // 27 (11)
-    206 % 64, // 28 (14)
-    210 % 64, // 29 (18)
-    213 % 64, // 30 (21)
-    216 % 64, // 31 (24)
-    220 % 64, // 32 (28)
-    223 % 64, // 33 (31)
-    226 % 64, // 34 (34)
-  };
   // Fetch upper 128 bits of the src[]
-  unsigned nb = nb_tab[n-DIV1_NMAX-1];
+  const uint64_t mulF_hx = recip_tab[n-1].mulF_hx;
+  const unsigned nb = (unsigned)(mulF_hx >> 56);
   unsigned wi0 = n < 24 ? 0 : 1;
   uint64_t srcH = (src[wi0+2] << (64-nb)) | (src[wi0+1] >> nb);
   uint64_t srcL = (src[wi0+1] << (64-nb)) | (src[wi0+0] >> nb);
 
-  static const struct {
-    uint64_t mulF_l;  // 10**n / 2
-    uint64_t mulF_h;
-    uint64_t invF_l;  // 2**(nb+64*3+13) / mulF
-    uint64_t invF_h;
-  } recip_tab2[NMAX-DIV1_NMAX] = {
-   {0x000000000000C350, 0x0000000000000000, 0x0FCF80DC33721D53, 0xA7C5AC471B478423 }, //  5
-   {0x000000000007A120, 0x0000000000000000, 0xA63F9A49C2C1B10F, 0x8637BD05AF6C69B5 }, //  6
-   {0x00000000004C4B40, 0x0000000000000000, 0x3D32907604691B4C, 0xD6BF94D5E57A42BC }, //  7
-   {0x0000000002FAF080, 0x0000000000000000, 0xFDC20D2B36BA7C3D, 0xABCC77118461CEFC }, //  8
-   {0x000000001DCD6500, 0x0000000000000000, 0x31680A88F8953030, 0x89705F4136B4A597 }, //  9
-   {0x000000012A05F200, 0x0000000000000000, 0xB573440E5A884D1B, 0xDBE6FECEBDEDD5BE }, // 10
-   {0x0000000BA43B7400, 0x0000000000000000, 0xF78F69A51539D748, 0xAFEBFF0BCB24AAFE }, // 11
-   {0x000000746A528800, 0x0000000000000000, 0xF93F87B7442E45D3, 0x8CBCCC096F5088CB }, // 12
-   {0x0000048C27395000, 0x0000000000000000, 0x2865A5F206B06FB9, 0xE12E13424BB40E13 }, // 13
-   {0x00002D79883D2000, 0x0000000000000000, 0x538484C19EF38C94, 0xB424DC35095CD80F }, // 14
-   {0x0001C6BF52634000, 0x0000000000000000, 0x0F9D37014BF60A10, 0x901D7CF73AB0ACD9 }, // 15
-   {0x0011C37937E08000, 0x0000000000000000, 0x4C2EBE687989A9B3, 0xE69594BEC44DE15B }, // 16
-   {0x00B1A2BC2EC50000, 0x0000000000000000, 0x09BEFEB9FAD487C2, 0xB877AA3236A4B449 }, // 17
-   {0x06F05B59D3B20000, 0x0000000000000000, 0x3AFF322E62439FCF, 0x9392EE8E921D5D07 }, // 18
-   {0x4563918244F40000, 0x0000000000000000, 0x2B31E9E3D06C32E5, 0xEC1E4A7DB69561A5 }, // 19
-   {0xB5E3AF16B1880000, 0x0000000000000002, 0x88F4BB1CA6BCF584, 0xBCE5086492111AEA }, // 20
-   {0x1AE4D6E2EF500000, 0x000000000000001B, 0xD3F6FC16EBCA5E03, 0x971DA05074DA7BEE }, // 21
-   {0x0CF064DD59200000, 0x000000000000010F, 0x5324C68B12DD6338, 0xF1C90080BAF72CB1 }, // 22
-   {0x8163F0A57B400000, 0x0000000000000A96, 0x75B7053C0F178293, 0xC16D9A0095928A27 }, // 23
-   {0x0DE76676D0800000, 0x00000000000069E1, 0xC4926A9672793542, 0x9ABE14CD44753B52 }, // 24
-   {0x8B0A00A425000000, 0x00000000000422CA, 0x9D41EEDEC1FA9102, 0x7BCB43D769F762A8 }, // 25
-   {0x6E64066972000000, 0x0000000000295BE9, 0x95364AFE032A819D, 0xC612062576589DDA }, // 26
-   {0x4FE8401E74000000, 0x00000000019D971E, 0x775EA264CF55347D, 0x9E74D1B791E07E48 }, // 27
-   {0x1F12813088000000, 0x000000001027E72F, 0xC5E54EB70C4429FE, 0x7EC3DAF941806506 }, // 28
-   {0x36B90BE550000000, 0x00000000A18F07D7, 0x096EE45813A04330, 0xCAD2F7F5359A3B3E }, // 29
-   {0x233A76F520000000, 0x000000064F964E68, 0xA1258379A94D028D, 0xA2425FF75E14FC31 }, // 30
-   {0x6048A59340000000, 0x0000003F1BDF1011, 0x80EACF948770CED7, 0x81CEB32C4B43FCF4 }, // 31
-   {0xC2D677C080000000, 0x0000027716B6A0AD, 0x67DE18EDA5814AF2, 0xCFB11EAD453994BA }, // 32
-   {0x9C60AD8500000000, 0x000018A6E32246C9, 0xECB1AD8AEACDD58E, 0xA6274BBDD0FADD61 }, // 33
-   {0x1BC6C73200000000, 0x0000F684DF56C3E0, 0xBD5AF13BEF0B113E, 0x84EC3C97DA624AB4 }, // 34
-  };
-  const uint64_t invF_h = recip_tab2[n-DIV1_NMAX-1].invF_h;
-  const uint64_t invF_l = recip_tab2[n-DIV1_NMAX-1].invF_l;
-  const uint64_t mulF_h = recip_tab2[n-DIV1_NMAX-1].mulF_h;
-  const uint64_t mulF_l = recip_tab2[n-DIV1_NMAX-1].mulF_l;
+  const uint64_t invF_h = recip_tab[n-1].invF_h;
+  const uint64_t invF_l = recip_tab[n-1].invF_l;
+  const uint64_t mulF_h = mulF_hx & (((uint64_t)1 << 56) - 1);
+  const uint64_t mulF_l = recip_tab[n-1].mulF_l;
   uint64_t src1 = src[1];
   uint64_t src0 = src[0];
 
@@ -190,6 +155,11 @@ int DivideDecimal68ByPowerOf10(uint64_t result[2], const uint64_t src[4], unsign
     rx += 1;
   }
   int steaky = rem != 0;
+  if (remainder) {
+    rem += mulF & (0 - (rx & 1)); // rx is 2*quotient
+    remainder[0] = (uint64_t)rem;
+    remainder[1] = (uint64_t)(rem >> 64);
+  }
 
   r1 = rx >> 64;
   r0 = rx;
@@ -224,9 +194,41 @@ int DivideDecimal68ByPowerOf10(uint64_t result[2], const uint64_t src[4], unsign
   }
 
   int steaky = (src0|src1) != 0;
+  if (remainder) {
+    const uint64_t odd_msk = 0 - (r0 & 1); // r1:r0 is 2*quotient
+    carry = _addcarry_u64(0,     src0, mulF_l & odd_msk, &remainder[0]);
+    carry = _addcarry_u64(carry, src1, mulF_h & odd_msk, &remainder[1]);
+  }
 #endif
 
   result[0] = (r1 << 63) | (r0 >> 1);
   result[1] = r1 >> 1;
   return (r0*2 & 2) | steaky;
 }
+
+// DivideDecimal68ByPowerOf10_srcshift - Divide unsigned integer number by power of ten
+//
+// Arguments:
+// result - result of division, 2 64-bit words, range [0:10**34-1], Little Endian
+// src    - source (dividend), 4 64-bit words, range [0:10**68-1], Little Endian
+// n      - decimal exponent of the divisor, i.e. divisor=10**n, range 0 to 34
+// Return value:  0 when remainder of division ==0
+//                1 when remainder of division >0 and < divisor/2,
+//                2 when remainder == divisor/2,
+//                3 when remainder > divisor/2
+//
+// Comments:
+// 1. It works only on Little Endian machines with sizeof(uint32_t)*2=sizeof(uint64_t)
+// 2. When src >= 10**n * 2**112 the results are incorrect, but the call is still legal
+//    in a sense that it causes no memory corruptions, traps or any other undefined actions
+int DivideDecimal68ByPowerOf10_srcshift(uint64_t result[2], const uint64_t src[4], unsigned n)
+{
+  return divide_srcshift(result, 0, src, n);
+}
+
+// DivModDecimal68ByPowerOf10_srcshift - DivideDecimal68ByPowerOf10_srcshift that also returns the remainder
+// See DivModDecimal68ByPowerOf10 in divide_pow10.h
+int DivModDecimal68ByPowerOf10_srcshift(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n)
+{
+  return divide_srcshift(result, remainder, src, n);
+}
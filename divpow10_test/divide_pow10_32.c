@@ -0,0 +1,67 @@
+#include "divide_pow10.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Reciprocal table, generated by mk_tab32.py
+// Division by 10**n/2 = 5**n * 2**(n-1) is done as division of x = src >> (n-1) by 5**n.
+// q = floor(floor(src / 2**src_shift) * invF / 2**(64+shift)) underestimates floor(x / 5**n) by at most 1
+// as long as src < 10**n * 2**56
+typedef struct {
+  uint64_t invF;      // floor(2**(64+e) / 5**n), where 2**e <= 5**n < 2**(e+1)
+  uint64_t mulF;      // 5**n
+  uint8_t  src_shift; // n-1+s, x >> s fits into 64 bits
+  uint8_t  shift;     // e-s
+} divpow10_32_recip_t;
+
+static const divpow10_32_recip_t recip32_tab[DIVPOW10_32_NMAX] = {
+ { 0xcccccccccccccccc, 0x0000000005,  0, 2 }, //  1
+ { 0xa3d70a3d70a3d70a, 0x0000000019,  1, 4 }, //  2
+ { 0x83126e978d4fdf3b, 0x000000007d,  2, 6 }, //  3
+ { 0xd1b71758e219652b, 0x0000000271,  6, 6 }, //  4
+ { 0xa7c5ac471b478423, 0x0000000c35,  9, 6 }, //  5
+ { 0x8637bd05af6c69b5, 0x0000003d09, 12, 6 }, //  6
+ { 0xd6bf94d5e57a42bc, 0x000001312d, 16, 6 }, //  7
+ { 0xabcc77118461cefc, 0x000005f5e1, 19, 6 }, //  8
+ { 0x89705f4136b4a597, 0x00001dcd65, 22, 6 }, //  9
+ { 0xdbe6fecebdedd5be, 0x00009502f9, 26, 6 }, // 10
+ { 0xafebff0bcb24aafe, 0x0002e90edd, 29, 6 }, // 11
+ { 0x8cbccc096f5088cb, 0x000e8d4a51, 32, 6 }, // 12
+ { 0xe12e13424bb40e13, 0x0048c27395, 36, 6 }, // 13
+ { 0xb424dc35095cd80f, 0x016bcc41e9, 39, 6 }, // 14
+ { 0x901d7cf73ab0acd9, 0x071afd498d, 42, 6 }, // 15
+ { 0xe69594bec44de15b, 0x2386f26fc1, 46, 6 }, // 16
+};
+
+int DivideDecimal32ByPowerOf10(uint64_t* result, const uint64_t src[2], unsigned n)
+{
+  if (n-1 > DIVPOW10_32_NMAX-1) {
+    *result = src[0];
+    return 0;
+  }
+  const divpow10_32_recip_t* recip = &recip32_tab[n-1];
+
+#ifndef _MSC_VER
+  typedef unsigned __int128 uintex_t;
+  const uintex_t s = ((uintex_t)src[1] << 64) | src[0];
+  const uint64_t x0 = (uint64_t)(s >> (n-1));           // LS word of x
+  const uint64_t t  = (uint64_t)(s >> recip->src_shift);
+  uint64_t q = (uint64_t)((uintex_t)t * recip->invF >> 64) >> recip->shift;
+#else
+  const uint64_t x0 = __shiftright128(src[0], src[1], (unsigned char)(n-1));
+  const uint64_t t  = __shiftright128(src[0], src[1], recip->src_shift);
+  uint64_t q = __umulh(t, recip->invF) >> recip->shift;
+#endif
+
+  // remainder x - q*5**n is below 2*5**n < 2**39, so LS word is sufficient
+  const uint64_t mulF = recip->mulF;
+  uint64_t rem = x0 - q * mulF;
+  const uint64_t corr_msk = 0 - (uint64_t)(rem >= mulF); // q underestimated
+  q   -= corr_msk;
+  rem -= mulF & corr_msk;
+
+  // q = floor(src / (10**n/2)), i.e. 2*quotient + 1 when the remainder is in the upper half
+  *result = q >> 1;
+  uint64_t steaky = rem | (src[0] & (((uint64_t)1 << (n-1)) - 1));
+  return ((int)q & 1) *2 + (steaky != 0);
+}
@@ -0,0 +1,200 @@
+#include "divide_pow10.h"
+#include "divide_pow10_tab.h"
+#include "divide_pow10_cpu.h"
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+// AVX2 has no 64x64 multiply, so everything below is built from vpmuludq (32x32->64)
+// The arithmetic is the same as in the non-MSVC path of divide_pow10.c, 4 elements at time
+
+// a*b, full 128-bit product, b32 = b >> 32
+static inline AVX2_TARGET __m256i umul128_4(__m256i a, __m256i b, __m256i b32, __m256i* hi)
+{
+  const __m256i M32 = _mm256_set1_epi64x(0xFFFFFFFF);
+  __m256i a32 = _mm256_srli_epi64(a, 32);
+  __m256i ll  = _mm256_mul_epu32(a,   b);
+  __m256i lh  = _mm256_mul_epu32(a,   b32);
+  __m256i hl  = _mm256_mul_epu32(a32, b);
+  __m256i hh  = _mm256_mul_epu32(a32, b32);
+  __m256i mid = _mm256_add_epi64(_mm256_srli_epi64(ll, 32), _mm256_and_si256(lh, M32));
+  mid = _mm256_add_epi64(mid, _mm256_and_si256(hl, M32)); // < 3*2**32, no overflow
+  *hi = _mm256_add_epi64(_mm256_add_epi64(hh, _mm256_srli_epi64(mid, 32)),
+                         _mm256_add_epi64(_mm256_srli_epi64(lh, 32), _mm256_srli_epi64(hl, 32)));
+  return _mm256_or_si256(_mm256_and_si256(ll, M32), _mm256_slli_epi64(mid, 32));
+}
+
+// a*b % 2**64, b32 = b >> 32
+static inline AVX2_TARGET __m256i mullo64_4(__m256i a, __m256i b, __m256i b32)
+{
+  __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(a, b32), _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b));
+  return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+}
+
+// all-ones when a < b, unsigned
+static inline AVX2_TARGET __m256i cmpltu_4(__m256i a, __m256i b)
+{
+  const __m256i SIGN = _mm256_set1_epi64x((long long)0x8000000000000000ull);
+  return _mm256_cmpgt_epi64(_mm256_xor_si256(b, SIGN), _mm256_xor_si256(a, SIGN));
+}
+
+// hi:lo += bh:bl, modulo 2**128
+static inline AVX2_TARGET void add128_4(__m256i* hi, __m256i* lo, __m256i bh, __m256i bl)
+{
+  __m256i l = _mm256_add_epi64(*lo, bl);
+  *hi = _mm256_sub_epi64(_mm256_add_epi64(*hi, bh), cmpltu_4(l, bl));
+  *lo = l;
+}
+
+// 8-byte field at the same byte offset inside every element: (w_lo >> bsh) | (w_hi << (64-bsh))
+// shift counts above 63 produce 0, so bsh=0 needs no special case
+static inline AVX2_TARGET __m256i funnel_4(__m256i w_lo, __m256i w_hi, __m128i bsh, __m128i lsh)
+{
+  return _mm256_or_si256(_mm256_srl_epi64(w_lo, bsh), _mm256_sll_epi64(w_hi, lsh));
+}
+
+static AVX2_TARGET void divide_column_avx2(uint64_t* const result[2], int ret[], const uint64_t* const src[4], unsigned n, size_t count)
+{
+  // Table row is the same for all elements - fetch it once
+  const divpow10_recip_t* recip = &divpow10_recip_tab[n-1];
+  const unsigned src_offs   = recip->src_offs;
+  const unsigned src_offsLL = recip->src_offsLL;
+  const unsigned rem_offs   = recip->rem_offs;
+  const uint64_t invF_m = recip->invF_m;
+  const uint64_t invF_h = recip->invF_h;
+
+  const __m256i v_invF_m   = _mm256_set1_epi64x((long long)invF_m);
+  const __m256i v_invF_m32 = _mm256_set1_epi64x((long long)(invF_m >> 32));
+  const __m256i v_invF_h   = _mm256_set1_epi64x((long long)invF_h);
+  const __m256i v_invF_h32 = _mm256_set1_epi64x((long long)(invF_h >> 32));
+  const __m256i v_invF_l   = _mm256_set1_epi64x((long long)recip->invF_l);
+  const __m256i v_mulF_l   = _mm256_set1_epi64x((long long)recip->mulF_l);
+  const __m256i v_mulF_l32 = _mm256_set1_epi64x((long long)(recip->mulF_l >> 32));
+  const __m256i v_steaky   = _mm256_set1_epi64x((long long)(((uint64_t)1 << rem_offs*8) - 1));
+  const __m256i v_rxxL_thr = _mm256_set1_epi64x((long long)((uint64_t)(-1) << 36));
+  const __m256i M32  = _mm256_set1_epi64x(0xFFFFFFFF);
+  const __m256i ZERO = _mm256_setzero_si256();
+  const __m256i ONE  = _mm256_set1_epi64x(1);
+
+  // Byte offsets of src fields translated into word planes and shift counts
+  const uint64_t* srcL_p0  = src[src_offs / 8];
+  const uint64_t* srcL_p1  = src[src_offs / 8 + 1];
+  const uint64_t* srcH_p1  = src[src_offs / 8 + 2];
+  const __m128i   src_bsh  = _mm_cvtsi32_si128((src_offs % 8) * 8);
+  const __m128i   src_lsh  = _mm_cvtsi32_si128(64 - (src_offs % 8) * 8);
+  const uint64_t* srcLL_p0 = src[src_offsLL / 8];
+  const uint64_t* srcLL_p1 = src[src_offsLL / 8 < 3 ? src_offsLL / 8 + 1 : 3];
+  const __m128i   LL_bsh   = _mm_cvtsi32_si128((src_offsLL % 8) * 8);
+  const __m128i   LL_lsh   = _mm_cvtsi32_si128(64 - (src_offsLL % 8) * 8);
+  const __m128i   LL_shift = _mm_cvtsi32_si128(recip->shift_LL);
+  const __m128i   rem_bsh  = _mm_cvtsi32_si128(rem_offs * 8);
+  const __m128i   rem_lsh  = _mm_cvtsi32_si128(64 - rem_offs * 8);
+
+  size_t i;
+  for (i = 0; i + 4 <= count; i += 4) {
+    __m256i w0 = _mm256_loadu_si256((const __m256i*)&src[0][i]);
+    __m256i w1 = _mm256_loadu_si256((const __m256i*)&src[1][i]);
+    __m256i wL0 = _mm256_loadu_si256((const __m256i*)&srcL_p0[i]);
+    __m256i wL1 = _mm256_loadu_si256((const __m256i*)&srcL_p1[i]);
+    __m256i wH1 = _mm256_loadu_si256((const __m256i*)&srcH_p1[i]);
+    __m256i srcL = funnel_4(wL0, wL1, src_bsh, src_lsh);
+    __m256i srcH = funnel_4(wL1, wH1, src_bsh, src_lsh);
+
+    // Multiplication by reciprocal
+    __m256i rxxL_h, rxxL_l = umul128_4(srcH, v_invF_m, v_invF_m32, &rxxL_h);
+    __m256i t_h, t_l;
+    umul128_4(srcL, v_invF_m, v_invF_m32, &t_h);
+    add128_4(&rxxL_h, &rxxL_l, ZERO, t_h);
+    t_l = umul128_4(srcL, v_invF_h, v_invF_h32, &t_h);
+    add128_4(&rxxL_h, &rxxL_l, t_h, t_l);
+    __m256i rxxLL = _mm256_mul_epu32(_mm256_srli_epi64(srcH, 32), v_invF_l);
+    __m256i srcLL = funnel_4(_mm256_loadu_si256((const __m256i*)&srcLL_p0[i]),
+                             _mm256_loadu_si256((const __m256i*)&srcLL_p1[i]), LL_bsh, LL_lsh);
+    srcLL = _mm256_and_si256(_mm256_sll_epi64(_mm256_and_si256(srcLL, M32), LL_shift), M32);
+    rxxLL = _mm256_add_epi64(rxxLL, _mm256_mul_epu32(srcLL, v_invF_h32)); // no overflow here
+    add128_4(&rxxL_h, &rxxL_l, ZERO, rxxLL);
+    __m256i r1, r0 = umul128_4(srcH, v_invF_h, v_invF_h32, &r1);
+    add128_4(&r1, &r0, ZERO, rxxL_h);
+
+    // calculate LS word of reminder
+    __m256i src0 = funnel_4(w0, w1, rem_bsh, rem_lsh);
+    __m256i rem0 = _mm256_sub_epi64(src0, mullo64_4(r0, v_mulF_l, v_mulF_l32));
+
+    // Fractional part is close to 1 and remainder >= divisor/2 - underflow
+    __m256i uf = _mm256_andnot_si256(cmpltu_4(rxxL_l, v_rxxL_thr), _mm256_xor_si256(cmpltu_4(rem0, v_mulF_l), _mm256_set1_epi64x(-1)));
+    rem0 = _mm256_sub_epi64(rem0, _mm256_and_si256(uf, v_mulF_l));
+    add128_4(&r1, &r0, ZERO, _mm256_and_si256(uf, ONE));
+
+    __m256i y0 = _mm256_or_si256(_mm256_slli_epi64(r1, 63), _mm256_srli_epi64(r0, 1));
+    __m256i y1 = _mm256_srli_epi64(r1, 1);
+    __m256i steaky = _mm256_or_si256(rem0, _mm256_and_si256(w0, v_steaky));
+    __m256i nz = _mm256_andnot_si256(_mm256_cmpeq_epi64(steaky, ZERO), ONE);
+    __m256i rc = _mm256_add_epi64(_mm256_slli_epi64(_mm256_and_si256(r0, ONE), 1), nz);
+    _mm256_storeu_si256((__m256i*)&result[0][i], y0);
+    _mm256_storeu_si256((__m256i*)&result[1][i], y1);
+    rc = _mm256_permutevar8x32_epi32(rc, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+    _mm_storeu_si128((__m128i*)&ret[i], _mm256_castsi256_si128(rc));
+  }
+  for (; i < count; ++i) {
+    uint64_t x[4] = { src[0][i], src[1][i], src[2][i], src[3][i] };
+    uint64_t y[2];
+    ret[i] = DivideDecimal68ByPowerOf10(y, x, n);
+    result[0][i] = y[0];
+    result[1][i] = y[1];
+  }
+}
+
+static void divide_column_scalar(uint64_t* const result[2], int ret[], const uint64_t* const src[4], unsigned n, size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t x[4] = { src[0][i], src[1][i], src[2][i], src[3][i] };
+    uint64_t y[2];
+    ret[i] = DivideDecimal68ByPowerOf10(y, x, n);
+    result[0][i] = y[0];
+    result[1][i] = y[1];
+  }
+}
+
+// The vector or scalar body is chosen once: on ELF targets with GNU C by an ifunc, resolved by the dynamic loader
+// before main(), elsewhere through a function pointer that is resolved on the first call
+typedef void (*divide_column_fn)(uint64_t* const result[2], int ret[], const uint64_t* const src[4], unsigned n, size_t count);
+
+static divide_column_fn select_column(void)
+{
+  return (DivPow10_CpuFeatures() & DIVPOW10_CPU_AVX2) ? divide_column_avx2 : divide_column_scalar;
+}
+
+#if defined(__GNUC__) && defined(__ELF__)
+
+static void divide_column(uint64_t* const result[2], int ret[], const uint64_t* const src[4], unsigned n, size_t count)
+  __attribute__((ifunc("select_column")));
+
+#else
+
+static void resolve_and_divide_column(uint64_t* const result[2], int ret[], const uint64_t* const src[4], unsigned n, size_t count);
+static divide_column_fn volatile divide_column = resolve_and_divide_column;
+
+static void resolve_and_divide_column(uint64_t* const result[2], int ret[], const uint64_t* const src[4], unsigned n, size_t count)
+{
+  divide_column = select_column();
+  divide_column(result, ret, src, n, count);
+}
+
+#endif
+
+void DivideDecimal68ByPowerOf10_Column(uint64_t* const result[2], int ret[], const uint64_t* const src[4], unsigned n, size_t count)
+{
+  if (n-1 > DIVPOW10_NMAX-1) {
+    for (size_t i = 0; i < count; ++i) {
+      result[0][i] = src[0][i];
+      result[1][i] = src[1][i];
+      ret[i] = 0;
+    }
+    return;
+  }
+  divide_column(result, ret, src, n, count);
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// Reciprocal tables are aligned to cache line and their rows are sized so that no row straddles a line,
+// so a call touches exactly one line of each table, even when the tables are cold
+#ifdef _MSC_VER
+#define DIVPOW10_CACHE_ALIGNED __declspec(align(64))
+#else
+#define DIVPOW10_CACHE_ALIGNED __attribute__((aligned(64)))
+#endif
+
+// Common bodies of several entries are forced inline into each of them, so checks of compile-time
+// arguments, e.g. remainder=0, are resolved at compile time
+#ifdef _MSC_VER
+#define DIVPOW10_FORCEINLINE __forceinline
+#else
+#define DIVPOW10_FORCEINLINE inline __attribute__((always_inline))
+#endif
+
+enum {
+  DIVPOW10_CPU_AVX512IFMA = 1 << 0, // AVX512F + AVX512IFMA, enabled by OS
+  DIVPOW10_CPU_AVX2       = 1 << 1, // AVX2, enabled by OS
+  DIVPOW10_CPU_BMI2       = 1 << 2, // mulx
+  DIVPOW10_CPU_ADX        = 1 << 3, // adcx, adox
+};
+
+// DivPow10_CpuFeatures - query host CPU and OS for instruction set extensions
+//
+// Return value: bit mask of DIVPOW10_CPU_xxx flags
+//
+// Comments:
+// Defined inline in the header, because it has to be callable from ifunc resolvers
+// and other code that runs before relocations are processed
+static inline unsigned DivPow10_CpuFeatures(void)
+{
+  unsigned r1[4], r7[4]; // eax, ebx, ecx, edx
+#ifdef _MSC_VER
+  int regs[4];
+  __cpuid(regs, 0);
+  if (regs[0] < 7)
+    return 0;
+  __cpuid(regs, 1);
+  for (int i = 0; i < 4; ++i) r1[i] = regs[i];
+  __cpuidex(regs, 7, 0);
+  for (int i = 0; i < 4; ++i) r7[i] = regs[i];
+#else
+  if (__get_cpuid_max(0, 0) < 7)
+    return 0;
+  __cpuid(1, r1[0], r1[1], r1[2], r1[3]);
+  __cpuid_count(7, 0, r7[0], r7[1], r7[2], r7[3]);
+#endif
+
+  uint64_t xcr0 = 0;
+  if (r1[2] & (1u << 27)) { // OSXSAVE
+#ifdef _MSC_VER
+    xcr0 = _xgetbv(0);
+#else
+    unsigned xcr0_l, xcr0_h;
+    __asm__ ("xgetbv" : "=a"(xcr0_l), "=d"(xcr0_h) : "c"(0));
+    xcr0 = ((uint64_t)xcr0_h << 32) | xcr0_l;
+#endif
+  }
+  const uint64_t XCR0_AVX    = 0x06; // XMM, YMM
+  const uint64_t XCR0_AVX512 = 0xE6; // XMM, YMM, opmask, ZMM_Hi256, Hi16_ZMM
+
+  unsigned ret = 0;
+  if ((xcr0 & XCR0_AVX512) == XCR0_AVX512 && (r7[1] & (1u << 16)) && (r7[1] & (1u << 21)))
+    ret |= DIVPOW10_CPU_AVX512IFMA;
+  if ((xcr0 & XCR0_AVX) == XCR0_AVX && (r7[1] & (1u << 5)))
+    ret |= DIVPOW10_CPU_AVX2;
+  if (r7[1] & (1u << 8))
+    ret |= DIVPOW10_CPU_BMI2;
+  if (r7[1] & (1u << 19))
+    ret |= DIVPOW10_CPU_ADX;
+  return ret;
+}
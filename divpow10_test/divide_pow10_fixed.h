@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+#include "divide_pow10_row.h"
+
+// DivideDecimal68ByPowerOf10<N> - Divide unsigned integer number by compile-time power of ten
+//
+// Arguments:
+// N      - decimal exponent of the divisor, i.e. divisor=10**N, range 0 to 34
+// result - result of division, 2 64-bit words, range [0:10**34-1], Little Endian
+// src    - source (dividend), 4 64-bit words, range [0:10**68-1], Little Endian
+// Return value: the same as DivideDecimal68ByPowerOf10(result, src, N)
+//
+// Comments:
+// 1. Header-only version of the algorithm of divide_pow10.c, the body is divide_generic_row of
+//    divide_pow10_row.h. All fields of the recip_tab row, including byte offsets and shift counts,
+//    are compile-time constants, so there is no table load and no range check, and the call can be inlined.
+// 2. It works only on byte-addressable Little Endian machines
+// 3. When src >= 10**N * 2**112 the results are incorrect, but the call is still legal
+//    in a sense that it causes no memory corruptions, traps or any other undefined actions
+template <unsigned N>
+inline int DivideDecimal68ByPowerOf10(uint64_t result[2], const uint64_t src[4])
+{
+  static_assert(N <= DIVPOW10_NMAX, "DivideDecimal68ByPowerOf10<N>: N out of range [0:34]");
+  if constexpr (N == 0) {
+    result[0] = src[0];
+    result[1] = src[1];
+    return 0;
+  } else {
+    constexpr divpow10_recip_t recip = divpow10_recip_tab[N-1];
+    constexpr uint32_t mulF_h = divpow10_mulF_h_tab[N-1];
+    return divide_generic_row(result, 0, src, recip, mulF_h);
+  }
+}
@@ -0,0 +1,255 @@
+#include "divide_pow10.h"
+#include "divide_pow10_cpu.h"
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#define IFMA_TARGET
+#else
+#define IFMA_TARGET __attribute__((target("avx512f,avx512ifma")))
+#endif
+
+// Reciprocal table, generated by mk_tab_ifma.py
+// All multi-precision values stored as 52-bit limbs, Little Endian
+// Q = floor(floor(src / 2**s) * R / 2**114) underestimates floor(src / 10**n) by at most 2
+// as long as src < 10**n * 2**113
+DIVPOW10_CACHE_ALIGNED static const struct {
+  uint64_t s;    // floor(log2(10**n))
+  uint64_t R[3]; // floor(2**(s+114) / 10**n)
+  uint64_t D[3]; // 10**n
+  uint64_t rsrv; // pad to 64 bytes
+} ifma_recip_tab[35] = {
+ { 0, { 0, 0, 0 }, { 0, 0, 0 }, 0 }, //  0
+ {  3, { 0x3333333333333, 0x3333333333333, 0x333 }, { 0x000000000000a, 0x0000000000000, 0x000 }, 0 }, //  1
+ {  6, { 0x8f5c28f5c28f5, 0x5c28f5c28f5c2, 0x28f }, { 0x0000000000064, 0x0000000000000, 0x000 }, 0 }, //  2
+ {  9, { 0xd916872b020c4, 0x49ba5e353f7ce, 0x20c }, { 0x00000000003e8, 0x0000000000000, 0x000 }, 0 }, //  3
+ { 13, { 0xf4f0d844d013a, 0xdc5d63886594a, 0x346 }, { 0x0000000002710, 0x0000000000000, 0x000 }, 0 }, //  4
+ { 16, { 0xc3f3e0370cdc8, 0x16b11c6d1e108, 0x29f }, { 0x00000000186a0, 0x0000000000000, 0x000 }, 0 }, //  5
+ { 19, { 0x698fe69270b06, 0xdef416bdb1a6d, 0x218 }, { 0x00000000f4240, 0x0000000000000, 0x000 }, 0 }, //  6
+ { 23, { 0x0f4ca41d811a4, 0xfe535795e90af, 0x35a }, { 0x0000000989680, 0x0000000000000, 0x000 }, 0 }, //  7
+ { 26, { 0x3f70834acdae9, 0x31dc4611873bf, 0x2af }, { 0x0000005f5e100, 0x0000000000000, 0x000 }, 0 }, //  8
+ { 29, { 0xcc5a02a23e254, 0xc17d04dad2965, 0x225 }, { 0x000003b9aca00, 0x0000000000000, 0x000 }, 0 }, //  9
+ { 33, { 0xad5cd10396a21, 0x9bfb3af7b756f, 0x36f }, { 0x00002540be400, 0x0000000000000, 0x000 }, 0 }, // 10
+ { 36, { 0xbde3da69454e7, 0xaffc2f2c92abf, 0x2bf }, { 0x000174876e800, 0x0000000000000, 0x000 }, 0 }, // 11
+ { 39, { 0xfe4fe1edd10b9, 0xf33025bd42232, 0x232 }, { 0x000e8d4a51000, 0x0000000000000, 0x000 }, 0 }, // 12
+ { 43, { 0xca19697c81ac1, 0xb84d092ed0384, 0x384 }, { 0x009184e72a000, 0x0000000000000, 0x000 }, 0 }, // 13
+ { 46, { 0xd4e1213067bce, 0x9370d42573603, 0x2d0 }, { 0x05af3107a4000, 0x0000000000000, 0x000 }, 0 }, // 14
+ { 49, { 0x43e74dc052fd8, 0x75f3dceac2b36, 0x240 }, { 0x38d7ea4c68000, 0x0000000000000, 0x000 }, 0 }, // 15
+ { 53, { 0xd30baf9a1e626, 0x5652fb1137856, 0x39a }, { 0x386f26fc10000, 0x0000000000002, 0x000 }, 0 }, // 16
+ { 56, { 0x426fbfae7eb52, 0xdea8c8da92d12, 0x2e1 }, { 0x345785d8a0000, 0x0000000000016, 0x000 }, 0 }, // 17
+ { 59, { 0xcebfcc8b9890e, 0x4bba3a4875741, 0x24e }, { 0x0b6b3a7640000, 0x00000000000de, 0x000 }, 0 }, // 18
+ { 63, { 0x4acc7a78f41b0, 0x7929f6da55869, 0x3b0 }, { 0x7230489e80000, 0x00000000008ac, 0x000 }, 0 }, // 19
+ { 66, { 0xa23d2ec729af3, 0x94219248446ba, 0x2f3 }, { 0x75e2d63100000, 0x00000000056bc, 0x000 }, 0 }, // 20
+ { 69, { 0xb4fdbf05baf29, 0x768141d369efb, 0x25c }, { 0x9adc5dea00000, 0x000000003635c, 0x000 }, 0 }, // 21
+ { 73, { 0x54c931a2c4b75, 0x240202ebdcb2c, 0x3c7 }, { 0x0c9bab2400000, 0x000000021e19e, 0x000 }, 0 }, // 22
+ { 76, { 0xdd6dc14f03c5e, 0xb66802564a289, 0x305 }, { 0x7e14af6800000, 0x000000152d02c, 0x000 }, 0 }, // 23
+ { 79, { 0xb1249aa59c9e4, 0xf8533511d4ed4, 0x26a }, { 0xecceda1000000, 0x000000d3c21bc, 0x000 }, 0 }, // 24
+ { 83, { 0x4ea0f76f60fd4, 0x5a1ebb4fbb154, 0x3de }, { 0x401484a000000, 0x0000084595161, 0x000 }, 0 }, // 25
+ { 86, { 0xa54d92bf80caa, 0x481895d962776, 0x318 }, { 0x80cd2e4000000, 0x000052b7d2dcc, 0x000 }, 0 }, // 26
+ { 89, { 0x1dd7a89933d54, 0xd346de4781f92, 0x279 }, { 0x0803ce8000000, 0x00033b2e3c9fd, 0x000 }, 0 }, // 27
+ { 93, { 0x62f2a75b86221, 0x1ed7ca0c03283, 0x3f6 }, { 0x5026110000000, 0x00204fce5e3e2, 0x000 }, 0 }, // 28
+ { 96, { 0x825bb91604e81, 0x4bdfd4d668ecf, 0x32b }, { 0x217caa0000000, 0x01431e0fae6d7, 0x000 }, 0 }, // 29
+ { 99, { 0x684960de6a534, 0x097fdd7853f0c, 0x289 }, { 0x4edea40000000, 0x0c9f2c9cd0467, 0x000 }, 0 }, // 30
+ {102, { 0x203ab3e521dc3, 0x3accb12d0ff3d, 0x207 }, { 0x14b2680000000, 0x7e37be2022c09, 0x000 }, 0 }, // 31
+ {106, { 0x99f7863b69605, 0xc47ab514e652e, 0x33e }, { 0xcef8100000000, 0xee2d6d415b85a, 0x004 }, 0 }, // 32
+ {109, { 0x7b2c6b62bab37, 0x9d2ef743eb758, 0x298 }, { 0x15b0a00000000, 0x4dc6448d9338c, 0x031 }, 0 }, // 33
+ {112, { 0x2f56bc4efbc2c, 0xb0f25f69892ad, 0x213 }, { 0xd8e6400000000, 0x09bead87c0378, 0x1ed }, 0 }, // 34
+};
+
+// subtract 3-limb values with borrow propagation, 52-bit limbs
+// results in d0:d1:d2, d0 and d1 normalized, sign of d2 is a sign of a-b
+#define SUB3_52(d0, d1, d2, a0, a1, a2, b0, b1, b2) \
+  d0 = _mm512_sub_epi64(a0, b0);                                                \
+  d1 = _mm512_add_epi64(_mm512_sub_epi64(a1, b1), _mm512_srai_epi64(d0, 52)); \
+  d2 = _mm512_add_epi64(_mm512_sub_epi64(a2, b2), _mm512_srai_epi64(d1, 52)); \
+  d0 = _mm512_and_si512(d0, M52);                                              \
+  d1 = _mm512_and_si512(d1, M52);
+
+// divide 8 elements
+// Comments: the method is different from DivideDecimal68ByPowerOf10.
+// Quotient estimate is 0 to 2 less than exact quotient. It is corrected using exact remainder
+// that is computed in 3 52-bit limbs, so rounding codes come directly from comparison of the remainder with divisor/2.
+static IFMA_TARGET void divide8(uint64_t result[8][2], int ret[8], const uint64_t src[8][4], const unsigned n[8])
+{
+  const __m512i M52  = _mm512_set1_epi64((1ull << 52) - 1);
+  const __m512i ZERO = _mm512_setzero_si512();
+  const __m512i ONE  = _mm512_set1_epi64(1);
+  const __m512i C64  = _mm512_set1_epi64(64);
+
+  // Load 8x4 words and transpose into word planes
+  __m512i a = _mm512_loadu_si512(&src[0][0]); // elements 0,1
+  __m512i b = _mm512_loadu_si512(&src[2][0]); // elements 2,3
+  __m512i c = _mm512_loadu_si512(&src[4][0]); // elements 4,5
+  __m512i d = _mm512_loadu_si512(&src[6][0]); // elements 6,7
+  const __m512i IDX_01 = _mm512_setr_epi64(0, 4, 8, 12, 1, 5, 9, 13);
+  const __m512i IDX_23 = _mm512_setr_epi64(2, 6, 10, 14, 3, 7, 11, 15);
+  const __m512i IDX_LO = _mm512_setr_epi64(0, 1, 2, 3, 8, 9, 10, 11);
+  const __m512i IDX_HI = _mm512_setr_epi64(4, 5, 6, 7, 12, 13, 14, 15);
+  __m512i ab01 = _mm512_permutex2var_epi64(a, IDX_01, b);
+  __m512i ab23 = _mm512_permutex2var_epi64(a, IDX_23, b);
+  __m512i cd01 = _mm512_permutex2var_epi64(c, IDX_01, d);
+  __m512i cd23 = _mm512_permutex2var_epi64(c, IDX_23, d);
+  __m512i w0 = _mm512_permutex2var_epi64(ab01, IDX_LO, cd01);
+  __m512i w1 = _mm512_permutex2var_epi64(ab01, IDX_HI, cd01);
+  __m512i w2 = _mm512_permutex2var_epi64(ab23, IDX_LO, cd23);
+  __m512i w3 = _mm512_permutex2var_epi64(ab23, IDX_HI, cd23);
+
+  // Fetch table rows, n out of range [1:34] maps to dummy row 0
+  __m512i nv = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)n));
+  __mmask8 valid = _mm512_cmplt_epu64_mask(_mm512_sub_epi64(nv, ONE), _mm512_set1_epi64(34));
+  __m512i ri = _mm512_maskz_mov_epi64(valid, _mm512_slli_epi64(nv, 3)); // row index in 64-bit words
+  const long long* tab = (const long long*)ifma_recip_tab;
+  __m512i s  = _mm512_i64gather_epi64(ri, tab + 0, 8);
+  __m512i r0 = _mm512_i64gather_epi64(ri, tab + 1, 8);
+  __m512i r1 = _mm512_i64gather_epi64(ri, tab + 2, 8);
+  __m512i r2 = _mm512_i64gather_epi64(ri, tab + 3, 8);
+  __m512i d0 = _mm512_i64gather_epi64(ri, tab + 4, 8);
+  __m512i d1 = _mm512_i64gather_epi64(ri, tab + 5, 8);
+  __m512i d2 = _mm512_i64gather_epi64(ri, tab + 6, 8);
+
+  // xh:xl = src >> s, s < 128
+  __mmask8 wsh = _mm512_test_epi64_mask(s, C64);
+  __m512i bsh = _mm512_and_si512(s, _mm512_set1_epi64(63));
+  __m512i lsh = _mm512_sub_epi64(C64, bsh); // shift by 64 produces 0
+  __m512i a0 = _mm512_mask_blend_epi64(wsh, w0, w1);
+  __m512i a1 = _mm512_mask_blend_epi64(wsh, w1, w2);
+  __m512i a2 = _mm512_mask_blend_epi64(wsh, w2, w3);
+  __m512i xl = _mm512_or_si512(_mm512_srlv_epi64(a0, bsh), _mm512_sllv_epi64(a1, lsh));
+  __m512i xh = _mm512_or_si512(_mm512_srlv_epi64(a1, bsh), _mm512_sllv_epi64(a2, lsh));
+  // convert to 52-bit limbs, xh < 2**50
+  __m512i x0 = _mm512_and_si512(xl, M52);
+  __m512i x1 = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(xl, 52), _mm512_slli_epi64(xh, 12)), M52);
+  __m512i x2 = _mm512_srli_epi64(xh, 40);
+
+  // P = x * R, column sums. x2*R2 < 2**20, so its high part is always 0
+  __m512i p0 = _mm512_madd52lo_epu64(ZERO, x0, r0);
+  __m512i p1 = _mm512_madd52hi_epu64(ZERO, x0, r0);
+  __m512i p2 = _mm512_madd52hi_epu64(ZERO, x0, r1);
+  __m512i p3 = _mm512_madd52hi_epu64(ZERO, x0, r2);
+  __m512i p4 = _mm512_madd52lo_epu64(ZERO, x2, r2);
+  p1 = _mm512_madd52lo_epu64(p1, x0, r1);
+  p1 = _mm512_madd52lo_epu64(p1, x1, r0);
+  p2 = _mm512_madd52lo_epu64(p2, x0, r2);
+  p2 = _mm512_madd52lo_epu64(p2, x1, r1);
+  p2 = _mm512_madd52lo_epu64(p2, x2, r0);
+  p2 = _mm512_madd52hi_epu64(p2, x1, r0);
+  p3 = _mm512_madd52lo_epu64(p3, x1, r2);
+  p3 = _mm512_madd52lo_epu64(p3, x2, r1);
+  p3 = _mm512_madd52hi_epu64(p3, x1, r1);
+  p3 = _mm512_madd52hi_epu64(p3, x2, r0);
+  p4 = _mm512_madd52hi_epu64(p4, x1, r2);
+  p4 = _mm512_madd52hi_epu64(p4, x2, r1);
+  p1 = _mm512_add_epi64(p1, _mm512_srli_epi64(p0, 52));
+  p2 = _mm512_add_epi64(p2, _mm512_srli_epi64(p1, 52));
+  p3 = _mm512_add_epi64(p3, _mm512_srli_epi64(p2, 52));
+  p4 = _mm512_add_epi64(p4, _mm512_srli_epi64(p3, 52));
+  p2 = _mm512_and_si512(p2, M52);
+  p3 = _mm512_and_si512(p3, M52);
+
+  // Quotient estimate q = P >> 114
+  __m512i q0 = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(p2, 10), _mm512_slli_epi64(p3, 42)), M52);
+  __m512i q1 = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(p3, 10), _mm512_slli_epi64(p4, 42)), M52);
+  __m512i q2 = _mm512_srli_epi64(p4, 10);
+
+  // Remainder = src - q*D modulo 2**156
+  __m512i s0 = _mm512_and_si512(w0, M52);
+  __m512i s1 = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(w0, 52), _mm512_slli_epi64(w1, 12)), M52);
+  __m512i s2 = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(w1, 40), _mm512_slli_epi64(w2, 24)), M52);
+  __m512i t0 = _mm512_madd52lo_epu64(ZERO, q0, d0);
+  __m512i t1 = _mm512_madd52hi_epu64(ZERO, q0, d0);
+  __m512i t2 = _mm512_madd52hi_epu64(ZERO, q0, d1);
+  t1 = _mm512_madd52lo_epu64(t1, q0, d1);
+  t1 = _mm512_madd52lo_epu64(t1, q1, d0);
+  t2 = _mm512_madd52hi_epu64(t2, q1, d0);
+  t2 = _mm512_madd52lo_epu64(t2, q0, d2);
+  t2 = _mm512_madd52lo_epu64(t2, q1, d1);
+  t2 = _mm512_madd52lo_epu64(t2, q2, d0);
+  __m512i m0, m1, m2;
+  SUB3_52(m0, m1, m2, s0, s1, s2, t0, t1, t2)
+  m2 = _mm512_and_si512(m2, M52);
+
+  // Remainder in range [0:3*D), two correction steps
+  for (int k = 0; k < 2; ++k) {
+    __m512i e0, e1, e2;
+    SUB3_52(e0, e1, e2, m0, m1, m2, d0, d1, d2)
+    __mmask8 ge = _mm512_cmpge_epi64_mask(e2, ZERO);
+    m0 = _mm512_mask_mov_epi64(m0, ge, e0);
+    m1 = _mm512_mask_mov_epi64(m1, ge, e1);
+    m2 = _mm512_mask_mov_epi64(m2, ge, e2);
+    q0 = _mm512_mask_add_epi64(q0, ge, q0, ONE);
+  }
+  q1 = _mm512_add_epi64(q1, _mm512_srli_epi64(q0, 52));
+  q0 = _mm512_and_si512(q0, M52);
+  q2 = _mm512_add_epi64(q2, _mm512_srli_epi64(q1, 52));
+  q1 = _mm512_and_si512(q1, M52);
+
+  // Rounding code: compare 2*remainder with D
+  __m512i f0 = _mm512_and_si512(_mm512_slli_epi64(m0, 1), M52);
+  __m512i f1 = _mm512_and_si512(_mm512_or_si512(_mm512_slli_epi64(m1, 1), _mm512_srli_epi64(m0, 51)), M52);
+  __m512i f2 = _mm512_or_si512(_mm512_slli_epi64(m2, 1), _mm512_srli_epi64(m1, 51));
+  __m512i g0, g1, g2;
+  SUB3_52(g0, g1, g2, f0, f1, f2, d0, d1, d2)
+  __m512i m = _mm512_or_si512(_mm512_or_si512(m0, m1), m2);
+  __mmask8 nz = _mm512_test_epi64_mask(m, m);
+  __mmask8 ge = _mm512_cmpge_epi64_mask(g2, ZERO);
+  __m512i g = _mm512_or_si512(_mm512_or_si512(g0, g1), g2);
+  __mmask8 gt = ge & _mm512_test_epi64_mask(g, g);
+  __m512i rc = _mm512_maskz_mov_epi64(nz & valid, ONE);
+  rc = _mm512_mask_add_epi64(rc, ge & valid, rc, ONE);
+  rc = _mm512_mask_add_epi64(rc, gt & valid, rc, ONE);
+
+  // Store results, copy of src for n out of range
+  __m512i y0 = _mm512_or_si512(q0, _mm512_slli_epi64(q1, 52));
+  __m512i y1 = _mm512_or_si512(_mm512_srli_epi64(q1, 12), _mm512_slli_epi64(q2, 40));
+  y0 = _mm512_mask_blend_epi64(valid, w0, y0);
+  y1 = _mm512_mask_blend_epi64(valid, w1, y1);
+  _mm512_storeu_si512(&result[0][0], _mm512_permutex2var_epi64(y0, _mm512_setr_epi64(0, 8, 1, 9, 2, 10, 3, 11), y1));
+  _mm512_storeu_si512(&result[4][0], _mm512_permutex2var_epi64(y0, _mm512_setr_epi64(4, 12, 5, 13, 6, 14, 7, 15), y1));
+  _mm256_storeu_si256((__m256i*)ret, _mm512_cvtepi64_epi32(rc));
+}
+
+static IFMA_TARGET void divide_batch_ifma(uint64_t result[][2], int ret[], const uint64_t src[][4], const unsigned n[], size_t count)
+{
+  size_t i;
+  for (i = 0; i + 8 <= count; i += 8)
+    divide8(&result[i], &ret[i], &src[i], &n[i]);
+  for (; i < count; ++i)
+    ret[i] = DivideDecimal68ByPowerOf10(result[i], src[i], n[i]);
+}
+
+static void divide_batch_scalar(uint64_t result[][2], int ret[], const uint64_t src[][4], const unsigned n[], size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+    ret[i] = DivideDecimal68ByPowerOf10(result[i], src[i], n[i]);
+}
+
+// DivideDecimal68ByPowerOf10_Batch is bound to divide_batch_ifma or divide_batch_scalar once: on ELF targets with GNU C
+// by an ifunc, resolved by the dynamic loader before main(), elsewhere through a function pointer resolved on the first call
+typedef void (*divide_batch_fn)(uint64_t result[][2], int ret[], const uint64_t src[][4], const unsigned n[], size_t count);
+
+static divide_batch_fn select_batch(void)
+{
+  return (DivPow10_CpuFeatures() & DIVPOW10_CPU_AVX512IFMA) ? divide_batch_ifma : divide_batch_scalar;
+}
+
+#if defined(__GNUC__) && defined(__ELF__)
+
+void DivideDecimal68ByPowerOf10_Batch(uint64_t result[][2], int ret[], const uint64_t src[][4], const unsigned n[], size_t count)
+  __attribute__((ifunc("select_batch")));
+
+#else
+
+static void resolve_and_divide_batch(uint64_t result[][2], int ret[], const uint64_t src[][4], const unsigned n[], size_t count);
+static divide_batch_fn volatile divide_batch_impl = resolve_and_divide_batch;
+
+static void resolve_and_divide_batch(uint64_t result[][2], int ret[], const uint64_t src[][4], const unsigned n[], size_t count)
+{
+  divide_batch_impl = select_batch();
+  divide_batch_impl(result, ret, src, n, count);
+}
+
+void DivideDecimal68ByPowerOf10_Batch(uint64_t result[][2], int ret[], const uint64_t src[][4], const unsigned n[], size_t count)
+{
+  divide_batch_impl(result, ret, src, n, count);
+}
+
+#endif
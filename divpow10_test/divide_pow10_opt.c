@@ -0,0 +1,338 @@
+#include "divide_pow10.h"
+#include "divide_pow10_variants.h"
+#include "divide_pow10_cpu.h"
+#include <string.h>
+
+#ifndef _MSC_VER
+// shr128 - bits [sh:sh+63] of hi:lo, sh in range 0 to 63
+// Shift of unsigned __int128 by variable count tests bit 6 of the count and selects by cmov, this is one shift less
+static inline uint64_t shr128(uint64_t lo, uint64_t hi, unsigned sh)
+{
+  return (lo >> sh) | ((hi << 1) << (63 - sh));
+}
+#endif
+
+enum { REM1_NMAX = 27, NMAX = 34 }; // 2*5**n < 2**64 for n <= REM1_NMAX
+
+// Rows are 32 bytes, the table is aligned to cache line, so one division reads one line
+// Generated by mk_tab_opt.py, that proves the error bound of the estimate for every n, see there
+DIVPOW10_CACHE_ALIGNED static const struct {
+  uint64_t invF_l;  // m = floor(2**k / 5**n), normalized to 128 bits
+  uint64_t invF_h;
+  uint64_t mulF_l;  // 5**n
+  uint64_t mulF_hx; // mulF_h | p << 48 | c << 56, p - position of the 128-bit window in src, c = k - (p-n+1) - 128
+} recip_tab[NMAX] = {
+   {0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCC, 0x0000000000000005, 0x0200000000000000 }, //  1
+   {0x3D70A3D70A3D70A3, 0xA3D70A3D70A3D70A, 0x0000000000000019, 0x0401000000000000 }, //  2
+   {0x645A1CAC083126E9, 0x83126E978D4FDF3B, 0x000000000000007D, 0x0602000000000000 }, //  3
+   {0xD3C36113404EA4A8, 0xD1B71758E219652B, 0x0000000000000271, 0x0903000000000000 }, //  4
+   {0x0FCF80DC33721D53, 0xA7C5AC471B478423, 0x0000000000000C35, 0x0B04000000000000 }, //  5
+   {0xA63F9A49C2C1B10F, 0x8637BD05AF6C69B5, 0x0000000000003D09, 0x0D05000000000000 }, //  6
+   {0x3D32907604691B4C, 0xD6BF94D5E57A42BC, 0x000000000001312D, 0x0D09000000000000 }, //  7
+   {0xFDC20D2B36BA7C3D, 0xABCC77118461CEFC, 0x000000000005F5E1, 0x0D0C000000000000 }, //  8
+   {0x31680A88F8953030, 0x89705F4136B4A597, 0x00000000001DCD65, 0x0D0F000000000000 }, //  9
+   {0xB573440E5A884D1B, 0xDBE6FECEBDEDD5BE, 0x00000000009502F9, 0x0D13000000000000 }, // 10
+   {0xF78F69A51539D748, 0xAFEBFF0BCB24AAFE, 0x0000000002E90EDD, 0x0D16000000000000 }, // 11
+   {0xF93F87B7442E45D3, 0x8CBCCC096F5088CB, 0x000000000E8D4A51, 0x0D19000000000000 }, // 12
+   {0x2865A5F206B06FB9, 0xE12E13424BB40E13, 0x0000000048C27395, 0x0D1D000000000000 }, // 13
+   {0x538484C19EF38C94, 0xB424DC35095CD80F, 0x000000016BCC41E9, 0x0D20000000000000 }, // 14
+   {0x0F9D37014BF60A10, 0x901D7CF73AB0ACD9, 0x000000071AFD498D, 0x0D23000000000000 }, // 15
+   {0x4C2EBE687989A9B3, 0xE69594BEC44DE15B, 0x0000002386F26FC1, 0x0D27000000000000 }, // 16
+   {0x09BEFEB9FAD487C2, 0xB877AA3236A4B449, 0x000000B1A2BC2EC5, 0x0D2A000000000000 }, // 17
+   {0x3AFF322E62439FCF, 0x9392EE8E921D5D07, 0x000003782DACE9D9, 0x0D2D000000000000 }, // 18
+   {0x2B31E9E3D06C32E5, 0xEC1E4A7DB69561A5, 0x00001158E460913D, 0x0D31000000000000 }, // 19
+   {0x88F4BB1CA6BCF584, 0xBCE5086492111AEA, 0x000056BC75E2D631, 0x0D34000000000000 }, // 20
+   {0xD3F6FC16EBCA5E03, 0x971DA05074DA7BEE, 0x0001B1AE4D6E2EF5, 0x0D37000000000000 }, // 21
+   {0x5324C68B12DD6338, 0xF1C90080BAF72CB1, 0x000878678326EAC9, 0x0D3B000000000000 }, // 22
+   {0x75B7053C0F178293, 0xC16D9A0095928A27, 0x002A5A058FC295ED, 0x0D3E000000000000 }, // 23
+   {0xC4926A9672793542, 0x9ABE14CD44753B52, 0x00D3C21BCECCEDA1, 0x0D41000000000000 }, // 24
+   {0x3A83DDBD83F52204, 0xF79687AED3EEC551, 0x0422CA8B0A00A425, 0x0E44000000000000 }, // 25
+   {0x95364AFE032A819D, 0xC612062576589DDA, 0x14ADF4B7320334B9, 0x0D48000000000000 }, // 26
+   {0x775EA264CF55347D, 0x9E74D1B791E07E48, 0x6765C793FA10079D, 0x0D4B000000000000 }, // 27
+   {0x8BCA9D6E188853FC, 0xFD87B5F28300CA0D, 0x04FCE5E3E2502611, 0x0E4E000000000002 }, // 28
+   {0x096EE45813A04330, 0xCAD2F7F5359A3B3E, 0x18F07D736B90BE55, 0x0D5200000000000A }, // 29
+   {0xA1258379A94D028D, 0xA2425FF75E14FC31, 0x7CB2734119D3B7A9, 0x0D55000000000032 }, // 30
+   {0x80EACF948770CED7, 0x81CEB32C4B43FCF4, 0x6F7C40458122964D, 0x0D580000000000FC }, // 31
+   {0x67DE18EDA5814AF2, 0xCFB11EAD453994BA, 0x2D6D415B85ACEF81, 0x0D5C0000000004EE }, // 32
+   {0xECB1AD8AEACDD58E, 0xA6274BBDD0FADD61, 0xE32246C99C60AD85, 0x0D5F0000000018A6 }, // 33
+   {0xBD5AF13BEF0B113E, 0x84EC3C97DA624AB4, 0x6FAB61F00DE36399, 0x0D62000000007B42 }, // 34
+};
+
+// divide_opt - common body of DivideDecimal68ByPowerOf10_opt and DivModDecimal68ByPowerOf10_opt
+// remainder=0 when the caller does not need it, n in range 1 to NMAX
+//
+// 10**n/2 = 5**n * 2**(n-1), so the power of two is shifted out of src and only 5**n needs a reciprocal.
+// The estimate of r = floor(src / (10**n/2)) is the product of a 128-bit window of src by 128-bit reciprocal,
+// without the low words of partial products, 3 multiplications. It is r or r-1 for all quotients below 10**34.
+// The remainder x - r*5**n of x = src >> (n-1) is below 2*5**n, that fits into one word up to REM1_NMAX,
+// so the correction costs one multiplication, instead of three for 2-word 10**n/2 in srcshift.
+//
+// The body is instantiated for every n, so the table row is folded into immediate operands and shift counts
+static DIVPOW10_FORCEINLINE int divide_opt(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], const unsigned n)
+{
+  const uint64_t invF_l  = recip_tab[n-1].invF_l;
+  const uint64_t invF_h  = recip_tab[n-1].invF_h;
+  const uint64_t mulF_l  = recip_tab[n-1].mulF_l;
+  const uint64_t mulF_hx = recip_tab[n-1].mulF_hx;
+  const unsigned p  = (unsigned)(mulF_hx >> 48) & 0xFF;
+  const unsigned c  = (unsigned)(mulF_hx >> 56);
+  const unsigned t  = n - 1;
+  const unsigned wi = p / 64, ws = p % 64;
+  const uint64_t lowMsk = ((uint64_t)1 << t) - 1; // bits of src below 10**n/2 granularity, go to sticky
+
+#ifndef _MSC_VER
+  typedef unsigned __int128 uintex_t;
+  // 128-bit window of src, p < 128, so it is within src[0:3]
+  const uint64_t srcL = shr128(src[wi+0], src[wi+1], ws);
+  const uint64_t srcH = shr128(src[wi+1], src[wi+2], ws);
+
+  // Multiplication by reciprocal, high words of the cross products only
+  uintex_t rx = (uintex_t)srcH * invF_h;
+  rx += (uint64_t)(((uintex_t)srcH * invF_l) >> 64);
+  rx += (uint64_t)(((uintex_t)srcL * invF_h) >> 64);
+  rx = ((uintex_t)((uint64_t)(rx >> 64) >> c) << 64) | shr128((uint64_t)rx, (uint64_t)(rx >> 64), c);
+
+  // x = src >> t, remainder x - rx*5**n
+  const uint64_t x0 = shr128(src[0], src[1], t);
+  if (n <= REM1_NMAX) {
+    uint64_t rem = x0 - (uint64_t)rx * mulF_l;
+    if (rem >= mulF_l) {
+      rem -= mulF_l;
+      rx  += 1;
+    }
+    if (remainder) {
+      const uintex_t rm = (uintex_t)(rem + (mulF_l & (0 - ((uint64_t)rx & 1)))) << t; // rx is 2*quotient
+      remainder[0] = (uint64_t)rm | (src[0] & lowMsk);
+      remainder[1] = (uint64_t)(rm >> 64);
+    }
+    result[0] = (uint64_t)(rx >> 1);
+    result[1] = (uint64_t)(rx >> 65);
+    return ((int)rx & 1) * 2 + ((rem | (src[0] & lowMsk)) != 0);
+  }
+
+  const uint64_t mulF_h = mulF_hx & (((uint64_t)1 << 48) - 1);
+  const uint64_t x1 = shr128(src[1], src[2], t);
+  uintex_t rem = ((uintex_t)x1 << 64) | x0;
+  rem -= (uintex_t)(uint64_t)rx * mulF_l;
+  rem -= (uintex_t)((uint64_t)(rx >> 64) * mulF_l + (uint64_t)rx * mulF_h) << 64;
+  const uintex_t mulF = ((uintex_t)mulF_h << 64) | mulF_l;
+  if (rem >= mulF) {
+    rem -= mulF;
+    rx  += 1;
+  }
+  if (remainder) {
+    const uintex_t rm = (rem + (mulF & (0 - (uintex_t)(rx & 1)))) << t;
+    remainder[0] = (uint64_t)rm | (src[0] & lowMsk);
+    remainder[1] = (uint64_t)(rm >> 64);
+  }
+  result[0] = (uint64_t)(rx >> 1);
+  result[1] = (uint64_t)(rx >> 65);
+  return ((int)rx & 1) * 2 + ((rem | (src[0] & lowMsk)) != 0);
+#else
+  // 128-bit window of src, p < 128, so it is within src[0:3]
+  const uint64_t srcL = __shiftright128(src[wi+0], src[wi+1], (unsigned char)ws);
+  const uint64_t srcH = __shiftright128(src[wi+1], src[wi+2], (unsigned char)ws);
+
+  // Multiplication by reciprocal, high words of the cross products only
+  uint64_t r1;
+  uint64_t r0 = _umul128(srcH, invF_h, &r1);
+  uint8_t carry;
+  carry = _addcarry_u64(0,     r0, __umulh(srcH, invF_l), &r0);
+  carry = _addcarry_u64(carry, r1, 0, &r1);
+  carry = _addcarry_u64(0,     r0, __umulh(srcL, invF_h), &r0);
+  carry = _addcarry_u64(carry, r1, 0, &r1);
+  r0 = __shiftright128(r0, r1, (unsigned char)c);
+  r1 = r1 >> c;
+
+  // x = src >> t, remainder x - r1:r0*5**n
+  const uint64_t x0 = __shiftright128(src[0], src[1], (unsigned char)t);
+  uint64_t rem0, rem1 = 0;
+  if (n <= REM1_NMAX) {
+    rem0 = x0 - r0 * mulF_l;
+    if (rem0 >= mulF_l) {
+      rem0 -= mulF_l;
+      carry = _addcarry_u64(0,     r0, 1, &r0);
+      carry = _addcarry_u64(carry, r1, 0, &r1);
+    }
+  } else {
+    const uint64_t mulF_h = mulF_hx & (((uint64_t)1 << 48) - 1);
+    const uint64_t x1 = __shiftright128(src[1], src[2], (unsigned char)t);
+    uint64_t mx_h;
+    uint64_t mx_l = _umul128(r0, mulF_l, &mx_h);
+    mx_h += r1*mulF_l + r0*mulF_h;
+    uint8_t borrow;
+    borrow = _subborrow_u64(0,      x0, mx_l, &rem0);
+    borrow = _subborrow_u64(borrow, x1, mx_h, &rem1);
+    uint64_t sub_l, sub_h;
+    borrow = _subborrow_u64(0,      rem0, mulF_l, &sub_l);
+    borrow = _subborrow_u64(borrow, rem1, mulF_h, &sub_h);
+    if (!borrow) {
+      rem0 = sub_l;
+      rem1 = sub_h;
+      carry = _addcarry_u64(0,     r0, 1, &r0);
+      carry = _addcarry_u64(carry, r1, 0, &r1);
+    }
+  }
+  if (remainder) {
+    const uint64_t odd_msk = 0 - (r0 & 1); // r1:r0 is 2*quotient
+    const uint64_t mulF_h = mulF_hx & (((uint64_t)1 << 48) - 1);
+    uint64_t rm0, rm1;
+    carry = _addcarry_u64(0,     rem0, mulF_l & odd_msk, &rm0);
+    carry = _addcarry_u64(carry, rem1, mulF_h & odd_msk, &rm1);
+    remainder[1] = __shiftleft128(rm0, rm1, (unsigned char)t);
+    remainder[0] = (rm0 << t) | (src[0] & lowMsk);
+  }
+  result[0] = (r1 << 63) | (r0 >> 1);
+  result[1] = r1 >> 1;
+  return ((int)r0 & 1) * 2 + (((rem0 | rem1) | (src[0] & lowMsk)) != 0);
+#endif
+}
+
+// Per-n kernels and their tables, indexed by n-1
+#define DIVPOW10_OPT_FOR_EACH_N(X) \
+  X( 1) X( 2) X( 3) X( 4) X( 5) X( 6) X( 7) X( 8) X( 9) X(10) X(11) X(12) X(13) X(14) X(15) X(16) X(17) \
+  X(18) X(19) X(20) X(21) X(22) X(23) X(24) X(25) X(26) X(27) X(28) X(29) X(30) X(31) X(32) X(33) X(34)
+
+#define DIVPOW10_OPT_KERNELS(N) \
+  static int divide_opt_##N(uint64_t result[2], const uint64_t src[4]) \
+  { return divide_opt(result, 0, src, N); } \
+  static int divmod_opt_##N(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4]) \
+  { return divide_opt(result, remainder, src, N); }
+DIVPOW10_OPT_FOR_EACH_N(DIVPOW10_OPT_KERNELS)
+
+#define DIVPOW10_OPT_DIVIDE_PTR(N) divide_opt_##N,
+#define DIVPOW10_OPT_DIVMOD_PTR(N) divmod_opt_##N,
+static int (* const divide_opt_tab[NMAX])(uint64_t result[2], const uint64_t src[4]) = {
+  DIVPOW10_OPT_FOR_EACH_N(DIVPOW10_OPT_DIVIDE_PTR)
+};
+static int (* const divmod_opt_tab[NMAX])(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4]) = {
+  DIVPOW10_OPT_FOR_EACH_N(DIVPOW10_OPT_DIVMOD_PTR)
+};
+
+// Per-n loops of DivideDecimal68ByPowerOf10_Bucketed over a list of element indices
+#define DIVPOW10_OPT_BUCKET_LOOP(N) \
+  static void divide_opt_bucket_##N(uint64_t result[][2], int ret[], const uint64_t src[][4], const uint16_t idx[], size_t count) \
+  { \
+    for (size_t k = 0; k < count; ++k) { \
+      const unsigned i = idx[k]; \
+      ret[i] = divide_opt(result[i], 0, src[i], N); \
+    } \
+  }
+DIVPOW10_OPT_FOR_EACH_N(DIVPOW10_OPT_BUCKET_LOOP)
+
+#define DIVPOW10_OPT_BUCKET_PTR(N) divide_opt_bucket_##N,
+static void (* const divide_opt_bucket_tab[NMAX])(uint64_t result[][2], int ret[], const uint64_t src[][4], const uint16_t idx[], size_t count) = {
+  DIVPOW10_OPT_FOR_EACH_N(DIVPOW10_OPT_BUCKET_PTR)
+};
+
+// Multiplications per n, estimate and correction, generated by mk_tab_opt.py, indexed by n-1
+// The search there covers truncated schoolbook products with 1- or 2-word window and reciprocal, every partial
+// product kept, kept as high word or dropped. 3 multiplications is the fewest for the estimate at every n,
+// so the counts are minimal within that family, other schemes are not searched.
+static const uint8_t mul_count_tab[NMAX] = {
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 6, 6, 6, 6, 6, 6, 6,
+};
+
+// DivPow10Opt_MulCount - number of multiplications DivideDecimal68ByPowerOf10_opt does for divisor 10**n
+unsigned DivPow10Opt_MulCount(unsigned n)
+{
+  if (n-1 > NMAX-1)
+    return 0;
+  return mul_count_tab[n-1];
+}
+
+// DivideDecimal68ByPowerOf10_opt - Divide unsigned integer number by power of ten
+//
+// Arguments:
+// result - result of division, 2 64-bit words, range [0:10**34-1], Little Endian
+// src    - source (dividend), 4 64-bit words, range [0:10**68-1], Little Endian
+// n      - decimal exponent of the divisor, i.e. divisor=10**n, range 0 to 34
+// Return value:  0 when remainder of division ==0
+//                1 when remainder of division >0 and < divisor/2,
+//                2 when remainder == divisor/2,
+//                3 when remainder > divisor/2
+//
+// Comments:
+// 1. It works only on Little Endian machines
+// 2. Every n has its own kernel, generated from the body of divide_opt, the call is dispatched through a table.
+//    The kernel is short only for a fixed n: when n changes from call to call, the indirect call mispredicts,
+//    and the variant is up to about 2 times slower than generic
+// 3. When src >= 10**n * 2**112 the results are incorrect, but the call is still legal
+//    in a sense that it causes no memory corruptions, traps or any other undefined actions
+int DivideDecimal68ByPowerOf10_opt(uint64_t result[2], const uint64_t src[4], unsigned n)
+{
+  if (n-1 > NMAX-1) {
+    result[0] = src[0];
+    result[1] = src[1];
+    return 0;
+  }
+  return divide_opt_tab[n-1](result, src);
+}
+
+// DivModDecimal68ByPowerOf10_opt - DivideDecimal68ByPowerOf10_opt that also returns the remainder
+// See DivModDecimal68ByPowerOf10 in divide_pow10.h
+int DivModDecimal68ByPowerOf10_opt(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n)
+{
+  if (n-1 > NMAX-1) {
+    result[0] = src[0];
+    result[1] = src[1];
+    remainder[0] = remainder[1] = 0;
+    return 0;
+  }
+  return divmod_opt_tab[n-1](result, remainder, src);
+}
+
+// Elements are sorted BUCKET_CHUNK at time, so the indices are 16-bit and src and results of a chunk stay in L1.
+// Histograms and insertion points are kept per BUCKET_WAYS interleaved streams of elements, otherwise
+// a run of equal n makes a chain of load-increment-store of the same counter.
+enum { BUCKET_CHUNK = 1024, BUCKET_WAYS = 4 };
+
+// DivideDecimal68ByPowerOf10_Bucketed - Divide array of unsigned integer numbers by powers of ten, grouped by exponent
+// See divide_pow10.h
+void DivideDecimal68ByPowerOf10_Bucketed(uint64_t result[][2], int ret[], const uint64_t src[][4], const unsigned n[], size_t count)
+{
+  uint16_t idx[BUCKET_CHUNK];
+  for (size_t base = 0; base < count; base += BUCKET_CHUNK) {
+    const unsigned m = (unsigned)(count - base < BUCKET_CHUNK ? count - base : BUCKET_CHUNK);
+    uint64_t (*res)[2] = result + base;
+    int* rt = ret + base;
+    const uint64_t (*sr)[4] = src + base;
+    const unsigned* nv = n + base;
+
+    // Counting sort of element indices by n, bucket 0 holds n=0 and n out of range
+    uint16_t pos[NMAX+1][BUCKET_WAYS];
+    memset(pos, 0, sizeof(pos));
+    unsigned i;
+    for (i = 0; i < m; ++i) {
+      const unsigned b = nv[i] > NMAX ? 0 : nv[i];
+      pos[b][i % BUCKET_WAYS] += 1;
+    }
+    unsigned start[NMAX+2];
+    unsigned acc = 0;
+    for (unsigned b = 0; b <= NMAX; ++b) {
+      start[b] = acc;
+      for (unsigned w = 0; w < BUCKET_WAYS; ++w) {
+        const unsigned c = pos[b][w];
+        pos[b][w] = (uint16_t)acc;
+        acc += c;
+      }
+    }
+    start[NMAX+1] = acc;
+    for (i = 0; i < m; ++i) {
+      const unsigned b = nv[i] > NMAX ? 0 : nv[i];
+      idx[pos[b][i % BUCKET_WAYS]++] = (uint16_t)i;
+    }
+
+    for (unsigned k = start[0]; k < start[1]; ++k) {
+      const unsigned j = idx[k];
+      res[j][0] = sr[j][0];
+      res[j][1] = sr[j][1];
+      rt[j] = 0;
+    }
+    for (unsigned b = 1; b <= NMAX; ++b) {
+      if (start[b+1] != start[b])
+        divide_opt_bucket_tab[b-1](res, rt, sr, &idx[start[b]], start[b+1] - start[b]);
+    }
+  }
+}
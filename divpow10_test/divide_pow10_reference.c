@@ -1,6 +1,27 @@
 #include "divide_pow10_reference.h"
 #include <string.h>
 
+// divide_ref - long division of src_words-word number by 10, n times
+static int divide_ref(uint64_t* result, unsigned res_words, const uint64_t* src, unsigned src_words, unsigned n)
+{
+  uint64_t steaky = 0;
+  uint64_t rem    = 0;
+  uint32_t x[16];
+  memcpy(x, src, sizeof(uint64_t)*src_words);
+  while (n > 0) {
+    steaky |= rem;
+    rem = 0;
+    for (int wi = src_words*2-1; wi >= 0; --wi) {
+      uint64_t d = (rem << 32) | x[wi];
+      x[wi] = (uint32_t)(d / 10);
+      rem = d % 10;
+    }
+    --n;
+  }
+  memcpy(result, x, sizeof(uint64_t)*res_words);
+  return rem < 5 ? (rem | steaky) != 0 : (((rem-5) | steaky) != 0) + 2;
+}
+
 // DivideDecimal68ByPowerOf10_ref - Divide unsigned integer number by power of ten
 //
 // Arguments:
@@ -15,20 +36,55 @@
 // Comments: It works only on Little Endian machine with sizeof(uint32_t)*2=sizeof(uint64_t)
 int DivideDecimal68ByPowerOf10_ref(uint64_t result[2], const uint64_t src[4], unsigned n)
 {
-  uint64_t steaky = 0;
-  uint64_t rem    = 0;
+  return divide_ref(result, 2, src, 4, n);
+}
+
+// DivideDecimal144ByPowerOf10_ref - Divide 8-word unsigned integer number by power of ten, n in range 0 to 72
+// Result is 4 words, return value is the same as of DivideDecimal68ByPowerOf10_ref
+int DivideDecimal144ByPowerOf10_ref(uint64_t result[4], const uint64_t src[8], unsigned n)
+{
+  return divide_ref(result, 4, src, 8, n);
+}
+
+// divide_ref_chunk - one pass of long division of 32-bit words x[0:nw-1] by d, d < 2**32
+// Return value: remainder
+static uint64_t divide_ref_chunk(uint32_t* x, int nw, uint32_t d)
+{
+  uint64_t rem = 0;
+  for (int wi = nw-1; wi >= 0; --wi) {
+    uint64_t v = (rem << 32) | x[wi];
+    x[wi] = (uint32_t)(v / d);
+    rem = v % d;
+  }
+  return rem;
+}
+
+// DivideDecimal68ByPowerOf10_fastref - Divide unsigned integer number by power of ten, independent reference
+// Arguments and return value are the same as of DivideDecimal68ByPowerOf10_ref
+//
+// Comments:
+// Divides first by 10**((n-1)%9+1), then by 10**9 at a time, so at most 4 passes of 8 divisions
+// instead of n passes. Remainders of all but the last pass only contribute to sticky, the last one
+// is compared with half of its own divisor, as the leading digits of the full remainder.
+int DivideDecimal68ByPowerOf10_fastref(uint64_t result[2], const uint64_t src[4], unsigned n)
+{
+  static const uint32_t pow10[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
   uint32_t x[8];
   memcpy(x, src, sizeof(x));
+  uint64_t steaky = 0;
+  uint64_t rem    = 0;
+  uint32_t d      = 1;
   while (n > 0) {
     steaky |= rem;
-    rem = 0;
-    for (int wi = 7; wi >= 0; --wi) {
-      uint64_t d = (rem << 32) | x[wi];
-      x[wi] = (uint32_t)(d / 10);
-      rem = d % 10;
-    }
-    --n;
+    const unsigned m = (n - 1) % 9 + 1; // partial chunk first, then 10**9 chunks
+    d   = pow10[m];
+    rem = divide_ref_chunk(x, 8, d);
+    n  -= m;
   }
   memcpy(result, x, sizeof(uint64_t)*2);
-  return rem < 5 ? (rem | steaky) != 0 : (((rem-5) | steaky) != 0) + 2;
-}
\ No newline at end of file
+  const uint64_t half = d / 2; // d=1 -> n=0, rem=0
+  if (rem < half || d == 1)
+    return (rem | steaky) != 0;
+  return rem == half && steaky == 0 ? 2 : 3;
+}
@@ -11,3 +11,17 @@
 //                2 when remainder == divisor/2,
 //                3 when remainder > divisor/2
 int DivideDecimal68ByPowerOf10_ref(uint64_t result[2], const uint64_t src[4], unsigned n);
+
+// DivideDecimal68ByPowerOf10_fastref - Divide unsigned integer number by power of ten
+// Arguments and return value are the same as of DivideDecimal68ByPowerOf10_ref
+// Written independently of it, by long division in 10**9 chunks, several times faster, for high-volume testing
+int DivideDecimal68ByPowerOf10_fastref(uint64_t result[2], const uint64_t src[4], unsigned n);
+
+// DivideDecimal144ByPowerOf10_ref - Divide unsigned integer number by power of ten
+//
+// Arguments:
+// result - result of division, 4 64-bit words, range [0:10**72-1], Little Endian
+// src    - source (dividend), 8 64-bit words, range [0:10**144-1], Little Endian
+// n      - decimal exponent of the divisor, i.e. divisor=10**n, range 0 to 72
+// Return value: the same as DivideDecimal68ByPowerOf10_ref
+int DivideDecimal144ByPowerOf10_ref(uint64_t result[4], const uint64_t src[8], unsigned n);
@@ -0,0 +1,179 @@
+#include "divide_pow10.h"
+#include "divide_pow10_cpu.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// See divide_pow10.h
+const uint16_t divpow10_round_inc_tab[8] = {
+  0xC8C8, // NEAREST_EVEN: code=3, or code=2 and odd
+  0xEE00, // DOWN:         code!=0 and negative
+  0x00EE, // UP:           code!=0 and positive
+  0x0000, // ZERO
+  0xCCCC, // NEAREST_AWAY: code>=2
+  0x0000, 0x0000, 0x0000,
+};
+
+int DivideRoundDecimal68ByPowerOf10(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned rnd_mode, unsigned sign, int* exp_adj)
+{
+  const uint64_t POW10_34_L = 0x378d8e6400000000ull, POW10_34_H = 0x0001ed09bead87c0ull;
+  const uint64_t POW10_33_L = 0x38c15b0a00000000ull, POW10_33_H = 0x0000314dc6448d93ull;
+
+  uint64_t q[2];
+  const int code = DivideDecimal68ByPowerOf10(q, src, n);
+  const unsigned idx = (unsigned)code | ((unsigned)q[0] & 1) << 2 | (sign & 1) << 3;
+  const uint64_t inc = (divpow10_round_inc_tab[rnd_mode & 7] >> idx) & 1;
+  const uint64_t q0 = q[0] + inc;
+  const uint64_t q1 = q[1] + (q0 < inc);
+
+  // 10**34 -> 10**33 with exponent adjustment
+  const uint64_t carry_msk = 0 - (uint64_t)((q0 == POW10_34_L) & (q1 == POW10_34_H));
+  result[0] = q0 ^ ((q0 ^ POW10_33_L) & carry_msk);
+  result[1] = q1 ^ ((q1 ^ POW10_33_H) & carry_msk);
+  *exp_adj = (int)(carry_msk & 1);
+  return code != 0;
+}
+
+// Tables of RoundDecimal68ToDigits, generated by mk_tab_round.py
+// digits_of_bits[b] - number of decimal digits of 2**(b-1), b-bit number has that many digits or one more
+static const uint8_t digits_of_bits[257] = {
+   1, 1, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 6, 6, 6, 7, 7, 7, 7, 8, 8, 8, 9, 9, 9,10,
+  10,10,10,11,11,11,12,12,12,13,13,13,13,14,14,14,15,15,15,16,16,16,16,17,17,17,18,18,18,19,19,19,
+  19,20,20,20,21,21,21,22,22,22,22,23,23,23,24,24,24,25,25,25,25,26,26,26,27,27,27,28,28,28,28,29,
+  29,29,30,30,30,31,31,31,32,32,32,32,33,33,33,34,34,34,35,35,35,35,36,36,36,37,37,37,38,38,38,38,
+  39,39,39,40,40,40,41,41,41,41,42,42,42,43,43,43,44,44,44,44,45,45,45,46,46,46,47,47,47,47,48,48,
+  48,49,49,49,50,50,50,50,51,51,51,52,52,52,53,53,53,53,54,54,54,55,55,55,56,56,56,56,57,57,57,58,
+  58,58,59,59,59,60,60,60,60,61,61,61,62,62,62,63,63,63,63,64,64,64,65,65,65,66,66,66,66,67,67,67,
+  68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,68,
+  68,
+};
+
+// powers of ten, 4 64-bit words, Little Endian, see divide_pow10.h
+DIVPOW10_CACHE_ALIGNED const uint64_t divpow10_pow10_tab[69][4] = {
+ { 0x0000000000000001, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, //  0
+ { 0x000000000000000a, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, //  1
+ { 0x0000000000000064, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, //  2
+ { 0x00000000000003e8, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, //  3
+ { 0x0000000000002710, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, //  4
+ { 0x00000000000186a0, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, //  5
+ { 0x00000000000f4240, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, //  6
+ { 0x0000000000989680, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, //  7
+ { 0x0000000005f5e100, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, //  8
+ { 0x000000003b9aca00, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, //  9
+ { 0x00000002540be400, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, // 10
+ { 0x000000174876e800, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, // 11
+ { 0x000000e8d4a51000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, // 12
+ { 0x000009184e72a000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, // 13
+ { 0x00005af3107a4000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, // 14
+ { 0x00038d7ea4c68000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, // 15
+ { 0x002386f26fc10000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, // 16
+ { 0x016345785d8a0000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, // 17
+ { 0x0de0b6b3a7640000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, // 18
+ { 0x8ac7230489e80000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }, // 19
+ { 0x6bc75e2d63100000, 0x0000000000000005, 0x0000000000000000, 0x0000000000000000 }, // 20
+ { 0x35c9adc5dea00000, 0x0000000000000036, 0x0000000000000000, 0x0000000000000000 }, // 21
+ { 0x19e0c9bab2400000, 0x000000000000021e, 0x0000000000000000, 0x0000000000000000 }, // 22
+ { 0x02c7e14af6800000, 0x000000000000152d, 0x0000000000000000, 0x0000000000000000 }, // 23
+ { 0x1bcecceda1000000, 0x000000000000d3c2, 0x0000000000000000, 0x0000000000000000 }, // 24
+ { 0x161401484a000000, 0x0000000000084595, 0x0000000000000000, 0x0000000000000000 }, // 25
+ { 0xdcc80cd2e4000000, 0x000000000052b7d2, 0x0000000000000000, 0x0000000000000000 }, // 26
+ { 0x9fd0803ce8000000, 0x00000000033b2e3c, 0x0000000000000000, 0x0000000000000000 }, // 27
+ { 0x3e25026110000000, 0x00000000204fce5e, 0x0000000000000000, 0x0000000000000000 }, // 28
+ { 0x6d7217caa0000000, 0x00000001431e0fae, 0x0000000000000000, 0x0000000000000000 }, // 29
+ { 0x4674edea40000000, 0x0000000c9f2c9cd0, 0x0000000000000000, 0x0000000000000000 }, // 30
+ { 0xc0914b2680000000, 0x0000007e37be2022, 0x0000000000000000, 0x0000000000000000 }, // 31
+ { 0x85acef8100000000, 0x000004ee2d6d415b, 0x0000000000000000, 0x0000000000000000 }, // 32
+ { 0x38c15b0a00000000, 0x0000314dc6448d93, 0x0000000000000000, 0x0000000000000000 }, // 33
+ { 0x378d8e6400000000, 0x0001ed09bead87c0, 0x0000000000000000, 0x0000000000000000 }, // 34
+ { 0x2b878fe800000000, 0x0013426172c74d82, 0x0000000000000000, 0x0000000000000000 }, // 35
+ { 0xb34b9f1000000000, 0x00c097ce7bc90715, 0x0000000000000000, 0x0000000000000000 }, // 36
+ { 0x00f436a000000000, 0x0785ee10d5da46d9, 0x0000000000000000, 0x0000000000000000 }, // 37
+ { 0x098a224000000000, 0x4b3b4ca85a86c47a, 0x0000000000000000, 0x0000000000000000 }, // 38
+ { 0x5f65568000000000, 0xf050fe938943acc4, 0x0000000000000002, 0x0000000000000000 }, // 39
+ { 0xb9f5610000000000, 0x6329f1c35ca4bfab, 0x000000000000001d, 0x0000000000000000 }, // 40
+ { 0x4395ca0000000000, 0xdfa371a19e6f7cb5, 0x0000000000000125, 0x0000000000000000 }, // 41
+ { 0xa3d9e40000000000, 0xbc627050305adf14, 0x0000000000000b7a, 0x0000000000000000 }, // 42
+ { 0x6682e80000000000, 0x5bd86321e38cb6ce, 0x00000000000072cb, 0x0000000000000000 }, // 43
+ { 0x011d100000000000, 0x9673df52e37f2410, 0x0000000000047bf1, 0x0000000000000000 }, // 44
+ { 0x0b22a00000000000, 0xe086b93ce2f768a0, 0x00000000002cd76f, 0x0000000000000000 }, // 45
+ { 0x6f5a400000000000, 0xc5433c60ddaa1640, 0x0000000001c06a5e, 0x0000000000000000 }, // 46
+ { 0x5986800000000000, 0xb4a05bc8a8a4de84, 0x00000000118427b3, 0x0000000000000000 }, // 47
+ { 0x7f41000000000000, 0x0e4395d69670b12b, 0x00000000af298d05, 0x0000000000000000 }, // 48
+ { 0xf88a000000000000, 0x8ea3da61e066ebb2, 0x00000006d79f8232, 0x0000000000000000 }, // 49
+ { 0xb564000000000000, 0x926687d2c40534fd, 0x000000446c3b15f9, 0x0000000000000000 }, // 50
+ { 0x15e8000000000000, 0xb8014e3ba83411e9, 0x000002ac3a4edbbf, 0x0000000000000000 }, // 51
+ { 0xdb10000000000000, 0x300d0e549208b31a, 0x00001aba4714957d, 0x0000000000000000 }, // 52
+ { 0x8ea0000000000000, 0xe0828f4db456ff0c, 0x00010b46c6cdd6e3, 0x0000000000000000 }, // 53
+ { 0x9240000000000000, 0xc51999090b65f67d, 0x000a70c3c40a64e6, 0x0000000000000000 }, // 54
+ { 0xb680000000000000, 0xb2fffa5a71fba0e7, 0x006867a5a867f103, 0x0000000000000000 }, // 55
+ { 0x2100000000000000, 0xfdffc78873d4490d, 0x04140c78940f6a24, 0x0000000000000000 }, // 56
+ { 0x4a00000000000000, 0xebfdcb54864ada83, 0x28c87cb5c89a2571, 0x0000000000000000 }, // 57
+ { 0xe400000000000000, 0x37e9f14d3eec8920, 0x97d4df19d6057673, 0x0000000000000001 }, // 58
+ { 0xe800000000000000, 0x2f236d04753d5b48, 0xee50b7025c36a080, 0x000000000000000f }, // 59
+ { 0x1000000000000000, 0xd762422c946590d9, 0x4f2726179a224501, 0x000000000000009f }, // 60
+ { 0xa000000000000000, 0x69d695bdcbf7a87a, 0x17877cec0556b212, 0x0000000000000639 }, // 61
+ { 0x4000000000000000, 0x2261d969f7ac94ca, 0xeb4ae1383562f4b8, 0x0000000000003e3a }, // 62
+ { 0x8000000000000000, 0x57d27e23acbdcfe6, 0x30eccc3215dd8f31, 0x0000000000026e4d }, // 63
+ { 0x0000000000000000, 0x6e38ed64bf6a1f01, 0xe93ff9f4daa797ed, 0x0000000000184f03 }, // 64
+ { 0x0000000000000000, 0x4e3945ef7a25360a, 0x1c7fc3908a8bef46, 0x0000000000f31627 }, // 65
+ { 0x0000000000000000, 0x0e3cbb5ac5741c64, 0x1cfda3a5697758bf, 0x00000000097edd87 }, // 66
+ { 0x0000000000000000, 0x8e5f518bb6891be8, 0x21e864761ea97776, 0x000000005ef4a747 }, // 67
+ { 0x0000000000000000, 0x8fb92f75215b1710, 0x5313ec9d329eaaa1, 0x00000003b58e88c7 }, // 68
+};
+
+// bit length of x, 1 for x=0
+static inline unsigned bitlen64(uint64_t x)
+{
+#ifdef _MSC_VER
+  unsigned long idx;
+  _BitScanReverse64(&idx, x | 1);
+  return (unsigned)idx + 1;
+#else
+  return 64 - (unsigned)__builtin_clzll(x | 1);
+#endif
+}
+
+int RoundDecimal68ToDigits(uint64_t result[2], const uint64_t src[4], unsigned p, unsigned rnd_mode, unsigned sign, unsigned* n_dropped)
+{
+  if (p - 1 > 33)
+    p = 34;
+  const uint64_t w0 = src[0], w1 = src[1], w2 = src[2], w3 = src[3];
+
+  // bit length without branches on data, conditional moves select the top non-zero word
+  unsigned nbits = bitlen64(w0);
+  nbits = w1 != 0 ? 64  + bitlen64(w1) : nbits;
+  nbits = w2 != 0 ? 128 + bitlen64(w2) : nbits;
+  nbits = w3 != 0 ? 192 + bitlen64(w3) : nbits;
+
+  // digits = dl or dl+1, one comparison src >= 10**dl as borrow of 256-bit subtraction
+  const unsigned dl = digits_of_bits[nbits];
+  const uint64_t* t = divpow10_pow10_tab[dl];
+  uint64_t borrow = w0 < t[0];
+  borrow = (w1 < t[1]) | ((w1 - t[1]) < borrow);
+  borrow = (w2 < t[2]) | ((w2 - t[2]) < borrow);
+  borrow = (w3 < t[3]) | ((w3 - t[3]) < borrow);
+  const unsigned digits = dl + (unsigned)(borrow ^ 1);
+  unsigned n = digits > p ? digits - p : 0;
+
+  uint64_t q[2];
+  int code;
+  if (n <= 34) {
+    code = DivideDecimal68ByPowerOf10(q, src, n);
+  } else { // p < 34 and more than 34+p digits, in two steps, the first one contributes to sticky bit
+    uint64_t q34[4] = { 0, 0, 0, 0 };
+    const int code1 = DivideDecimal68ByPowerOf10(q34, src, 34);
+    code = DivideDecimal68ByPowerOf10(q, q34, n - 34) | (code1 != 0);
+  }
+
+  const unsigned idx = (unsigned)code | ((unsigned)q[0] & 1) << 2 | (sign & 1) << 3;
+  const uint64_t inc = (divpow10_round_inc_tab[rnd_mode & 7] >> idx) & 1;
+  const uint64_t q0 = q[0] + inc;
+  const uint64_t q1 = q[1] + (q0 < inc);
+
+  // 10**p -> 10**(p-1) with one more dropped digit
+  const uint64_t carry_msk = 0 - (uint64_t)((q0 == divpow10_pow10_tab[p][0]) & (q1 == divpow10_pow10_tab[p][1]));
+  result[0] = q0 ^ ((q0 ^ divpow10_pow10_tab[p-1][0]) & carry_msk);
+  result[1] = q1 ^ ((q1 ^ divpow10_pow10_tab[p-1][1]) & carry_msk);
+  *n_dropped = n + (unsigned)(carry_msk & 1);
+  return code != 0;
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include "divide_pow10_tab.h"
+
+// divide_generic_row - body of DivideDecimal68ByPowerOf10_generic and DivideDecimal68ByPowerOf10<N> for one row
+// of divpow10_recip_tab, n in range 1 to 34. recip and mulF_h_row are the rows of divpow10_recip_tab
+// and divpow10_mulF_h_tab for n, remainder=0 when the caller does not need it.
+// Force-inlined: divide_pow10.c passes rows loaded from the tables, the template passes constexpr rows,
+// that are folded into immediates.
+static DIVPOW10_FORCEINLINE int divide_generic_row(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4],
+  const divpow10_recip_t recip, const uint32_t mulF_h_row)
+{
+  // Fetch upper 128 bits of the src[]
+  // Attention this code works only on byte-addressable Little Endian machines!
+  const unsigned src_offs = recip.src_offs;
+  const uint64_t steaky_msk = ((uint64_t)1 << recip.rem_offs*8) - 1;
+  uint64_t srcH, srcL;
+  memcpy(&srcH, (const char*)src + src_offs + 8, sizeof(srcH));
+  memcpy(&srcL, (const char*)src + src_offs + 0, sizeof(srcL));
+
+#ifndef _MSC_VER
+  // Multiplication by reciprocal
+  typedef unsigned __int128 uintex_t;
+  const uint64_t invF_m = recip.invF_m;
+  const uint64_t invF_h = recip.invF_h;
+  uintex_t rxxL = (uintex_t)srcH * invF_m;
+  rxxL         += (uint64_t)((uintex_t)srcL * invF_m >> 64);
+  rxxL         += (uintex_t)srcL * invF_h;
+  uint64_t rxxLL = (srcH >> 32) * (uint64_t)recip.invF_l;
+  uint32_t srcLL;
+  memcpy(&srcLL, (const char*)src + recip.src_offsLL, sizeof(srcLL));
+  srcLL <<= recip.shift_LL;
+  rxxLL += srcLL * (invF_h >> 32); // no overflow here
+  rxxL += rxxLL;
+  uintex_t rx = (uintex_t)srcH * invF_h + (uint64_t)(rxxL >> 64);
+
+  // calculate LS word of reminder
+  const uint64_t mulF_l = recip.mulF_l;
+  uint64_t src0;
+  memcpy(&src0, (const char*)src + recip.rem_offs, sizeof(src0));
+  uint64_t rem0 = src0 - (uint64_t)rx * mulF_l;  // remainder in rem0
+
+  const uint64_t rxxL_thr = (uint64_t)(-1) << 36;
+  if ((uint64_t)rxxL >= rxxL_thr) {
+    // Fractional part is close to 1, check for underflow
+    if (rem0 >= mulF_l) {
+      #if REPORT_UNDERFLOWS
+      gl_underflow = 1;
+      #endif
+      rem0 -= mulF_l;
+      rx += 1;
+    }
+  }
+  uint64_t r1 = rx >> 64;
+  uint64_t r0 = rx;
+
+  if (remainder) {
+    // src >> 8*rem_offs = rx*mulF + rem, 0 <= rem < mulF < 2**81, so the low 128 bits are sufficient
+    uint64_t src1;
+    memcpy(&src1, (const char*)src + recip.rem_offs + 8, sizeof(src1));
+    const uintex_t mulF = ((uintex_t)mulF_h_row << 64) | mulF_l;
+    uintex_t rem = (((uintex_t)src1 << 64) | src0) - rx * mulF;
+    rem += mulF & (0 - (rx & 1)); // rx is 2*quotient, odd rx leaves the upper half of divisor in the remainder
+    rem = (rem << recip.rem_offs*8) | (src[0] & steaky_msk);
+    remainder[0] = (uint64_t)rem;
+    remainder[1] = (uint64_t)(rem >> 64);
+  }
+#else
+  // Multiplication by reciprocal
+  const uint64_t invF_m = recip.invF_m;
+  uint64_t rF, r0, r1, rxLH0, rxLH1, rxHH0;
+  rF   = _umul128(srcH, invF_m, &r0);
+  uint8_t carry;
+  carry = _addcarry_u64(0,     rF, __umulh(srcL, invF_m), &rF);
+  carry = _addcarry_u64(carry, r0, 0,                     &r0);
+  const uint64_t invF_h = recip.invF_h;
+  rxLH0 = _umul128(srcL, invF_h, &rxLH1);
+  carry = _addcarry_u64(0,     rF, rxLH0, &rF);
+  carry = _addcarry_u64(carry, r0, rxLH1, &r0);
+  uint64_t rxxLL = (srcH >> 32) * (uint64_t)recip.invF_l;
+  uint32_t srcLL;
+  memcpy(&srcLL, (const char*)src + recip.src_offsLL, sizeof(srcLL));
+  srcLL <<= recip.shift_LL;
+  rxxLL += srcLL * (invF_h >> 32); // no overflow here
+  carry = _addcarry_u64(0,     rF, rxxLL, &rF);
+  carry = _addcarry_u64(carry, r0, 0,     &r0);
+  rxHH0 = _umul128(srcH, invF_h, &r1);
+  carry = _addcarry_u64(0,     r0, rxHH0, &r0);
+  carry = _addcarry_u64(carry, r1, 0,     &r1);
+  // Integer part of result in r1:r0. Fractional part in rF
+
+  // calculate LS word of reminder
+  const uint64_t mulF_l = recip.mulF_l;
+  uint64_t src0;
+  memcpy(&src0, (const char*)src + recip.rem_offs, sizeof(src0));
+  uint64_t rem0 = src0 - (uint64_t)r0 * mulF_l;  // remainder in rem0
+
+  const uint64_t rF_thr = (uint64_t)(-1) << 36;
+  if (rF >= rF_thr) {
+    // Fractional part is close to 1, check for underflow
+    if (rem0 >= mulF_l) {
+      #if REPORT_UNDERFLOWS
+      gl_underflow = 1;
+      #endif
+      rem0 -= mulF_l;
+      carry = _addcarry_u64(0,     r0, 1, &r0);
+      carry = _addcarry_u64(carry, r1, 0, &r1);
+    }
+  }
+
+  if (remainder) {
+    // src >> 8*rem_offs = r1:r0*mulF + rem, 0 <= rem < mulF < 2**81, so the low 128 bits are sufficient
+    uint64_t src1;
+    memcpy(&src1, (const char*)src + recip.rem_offs + 8, sizeof(src1));
+    const uint64_t mulF_h = mulF_h_row;
+    uint64_t mx_h;
+    uint64_t mx_l = _umul128(r0, mulF_l, &mx_h);
+    mx_h += r0*mulF_h + r1*mulF_l;
+    uint64_t rm0, rm1;
+    uint8_t borrow;
+    borrow = _subborrow_u64(0,      src0, mx_l, &rm0);
+    borrow = _subborrow_u64(borrow, src1, mx_h, &rm1);
+    const uint64_t odd = 0 - (r0 & 1); // r1:r0 is 2*quotient, odd value leaves the upper half of divisor in the remainder
+    carry = _addcarry_u64(0,     rm0, mulF_l & odd, &rm0);
+    carry = _addcarry_u64(carry, rm1, mulF_h & odd, &rm1);
+    const unsigned sh = recip.rem_offs*8;
+    remainder[1] = __shiftleft128(rm0, rm1, (unsigned char)sh);
+    remainder[0] = (rm0 << sh) | (src[0] & steaky_msk);
+  }
+#endif
+
+  result[0] = (r1 << 63) | (r0 >> 1);
+  result[1] = r1 >> 1;
+  uint64_t steaky = rem0 | (src[0] & steaky_msk);
+  return ((int)r0 & 1) *2 + (steaky != 0);
+}
@@ -0,0 +1,104 @@
+#include "divide_pow10.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define DIVPOW10_THREAD_LOCAL __declspec(thread)
+// volatile accesses of MSVC have acquire and release semantics (/volatile:ms)
+#define TRACE_LOAD(p)     (*(p))
+#define TRACE_STORE(p, v) (*(p) = (v))
+#define TRACE_LOCK(p)     while (_InterlockedExchange((p), 1) != 0) {}
+#else
+#define DIVPOW10_THREAD_LOCAL __thread
+#define TRACE_LOAD(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define TRACE_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define TRACE_LOCK(p)     while (__atomic_exchange_n((p), 1, __ATOMIC_ACQUIRE) != 0) {}
+#endif
+#define TRACE_UNLOCK(p)   TRACE_STORE((p), 0)
+
+enum { TRACE_BUF_RECORDS = 256 }; // per thread, 8 KB
+
+// trace_epoch is incremented by every open and every close, it is odd while trace file is open.
+// trace_fp is accessed only under trace_lock, so a thread never writes to a file, closed by another thread.
+static volatile long     trace_lock;
+static volatile unsigned trace_epoch;
+static FILE*             trace_fp;
+
+// Records of the calling thread, taken while trace_epoch was trace_buf_epoch. They belong to that trace only:
+// when the epoch moves on, they are dropped and never leak into a later trace.
+static DIVPOW10_THREAD_LOCAL uint64_t trace_buf[TRACE_BUF_RECORDS][4];
+static DIVPOW10_THREAD_LOCAL unsigned trace_len;
+static DIVPOW10_THREAD_LOCAL unsigned trace_buf_epoch;
+
+// trace_write - write buffer of the calling thread when it belongs to the open trace, trace_lock is held
+static void trace_write(void)
+{
+  if (trace_fp && trace_len > 0 && trace_buf_epoch == trace_epoch)
+    fwrite(trace_buf, DIVPOW10_TRACE_REC_SIZE, trace_len, trace_fp);
+  trace_len = 0;
+}
+
+int DivPow10_TraceOpen(const char* fname)
+{
+  DivPow10_TraceClose();
+  FILE* fp = fopen(fname, "wb");
+  if (!fp)
+    return 0;
+  uint8_t hdr[DIVPOW10_TRACE_HDR_SIZE] = { 0 };
+  memcpy(hdr, DIVPOW10_TRACE_MAGIC, 8);
+  hdr[8] = DIVPOW10_TRACE_REC_SIZE;
+  if (fwrite(hdr, sizeof(hdr), 1, fp) != 1) {
+    fclose(fp);
+    return 0;
+  }
+  TRACE_LOCK(&trace_lock);
+  if (trace_fp) { // opened by another thread meanwhile
+    fclose(trace_fp);
+    TRACE_STORE(&trace_epoch, trace_epoch + 1);
+  }
+  trace_fp = fp;
+  TRACE_STORE(&trace_epoch, trace_epoch + 1);
+  TRACE_UNLOCK(&trace_lock);
+  return 1;
+}
+
+void DivPow10_TraceFlush(void)
+{
+  if (trace_len == 0)
+    return;
+  TRACE_LOCK(&trace_lock);
+  trace_write();
+  TRACE_UNLOCK(&trace_lock);
+}
+
+void DivPow10_TraceClose(void)
+{
+  TRACE_LOCK(&trace_lock);
+  trace_write();
+  if (trace_fp) {
+    fclose(trace_fp);
+    trace_fp = 0;
+    TRACE_STORE(&trace_epoch, trace_epoch + 1);
+  }
+  TRACE_UNLOCK(&trace_lock);
+}
+
+int DivideDecimal68ByPowerOf10_Traced(uint64_t result[2], const uint64_t src[4], unsigned n)
+{
+  const unsigned epoch = TRACE_LOAD(&trace_epoch);
+  if ((epoch & 1) && (src[3] >> 56) == 0 && n < 256) {
+    if (trace_buf_epoch != epoch) { // first call of this thread in a new trace, drop records of the old one
+      trace_buf_epoch = epoch;
+      trace_len = 0;
+    }
+    uint64_t* rec = trace_buf[trace_len];
+    rec[0] = src[0];
+    rec[1] = src[1];
+    rec[2] = src[2];
+    rec[3] = src[3] | ((uint64_t)n << 56);
+    if (++trace_len == TRACE_BUF_RECORDS)
+      DivPow10_TraceFlush();
+  }
+  return DivideDecimal68ByPowerOf10(result, src, n);
+}
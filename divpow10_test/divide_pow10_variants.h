@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include "divide_pow10_cpu.h"
+
+// Implementations of DivideDecimal68ByPowerOf10 under distinct names
+// All have the same contract as DivideDecimal68ByPowerOf10, see divide_pow10.h
+// DivideDecimal68ByPowerOf10 itself is the branchless one, see the end of divide_pow10branchless.c
+
+// Each implementation file has a common body for the Divide and DivMod entries, forced inline into both
+// with DIVPOW10_FORCEINLINE of divide_pow10_cpu.h, so the code for the remainder is dropped from the Divide entry
+// at compile time
+
+// Qualifier of array parameters that don't overlap, as in result[DIVPOW10_RESTRICT 2][2]
+// MSVC takes no qualifiers in array declarators, there it is empty
+#ifdef _MSC_VER
+#define DIVPOW10_RESTRICT
+#else
+#define DIVPOW10_RESTRICT __restrict
+#endif
+
+typedef int (*DivideDecimal68ByPowerOf10_fn)(uint64_t result[2], const uint64_t src[4], unsigned n);
+
+int DivideDecimal68ByPowerOf10_generic(uint64_t result[2], const uint64_t src[4], unsigned n);    // divide_pow10.c
+int DivideDecimal68ByPowerOf10_branchless(uint64_t result[2], const uint64_t src[4], unsigned n); // divide_pow10branchless.c
+int DivideDecimal68ByPowerOf10_srcshift(uint64_t result[2], const uint64_t src[4], unsigned n);   // divide_pow10.srcshift.c
+int DivideDecimal68ByPowerOf10_adx(uint64_t result[2], const uint64_t src[4], unsigned n);        // divide_pow10adx.c, requires BMI2 and ADX
+int DivideDecimal68ByPowerOf10_opt(uint64_t result[2], const uint64_t src[4], unsigned n);        // divide_pow10_opt.c
+
+// Implementations of DivModDecimal68ByPowerOf10, one per implementation of DivideDecimal68ByPowerOf10
+typedef int (*DivModDecimal68ByPowerOf10_fn)(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n);
+
+int DivModDecimal68ByPowerOf10_generic(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n);
+int DivModDecimal68ByPowerOf10_branchless(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n);
+int DivModDecimal68ByPowerOf10_srcshift(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n);
+int DivModDecimal68ByPowerOf10_adx(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n);
+int DivModDecimal68ByPowerOf10_opt(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n);
+
+// Multi-lane entries, see DivideDecimal68ByPowerOf10_x2 and DivideDecimal68ByPowerOf10_x4 in divide_pow10.h
+typedef void (*DivideDecimal68ByPowerOf10_x2_fn)(uint64_t result[2][2], int ret[2], const uint64_t src[2][4], const unsigned n[2]);
+typedef void (*DivideDecimal68ByPowerOf10_x4_fn)(uint64_t result[4][2], int ret[4], const uint64_t src[4][4], const unsigned n[4]);
+
+void DivideDecimal68ByPowerOf10_branchless_x2(uint64_t result[2][2], int ret[2], const uint64_t src[2][4], const unsigned n[2]);
+void DivideDecimal68ByPowerOf10_branchless_x4(uint64_t result[4][2], int ret[4], const uint64_t src[4][4], const unsigned n[4]);
+void DivideDecimal68ByPowerOf10_adx_x2(uint64_t result[2][2], int ret[2], const uint64_t src[2][4], const unsigned n[2]);
+void DivideDecimal68ByPowerOf10_adx_x4(uint64_t result[4][2], int ret[4], const uint64_t src[4][4], const unsigned n[4]);
+
+// DivPow10Opt_MulCount - number of multiplications of DivideDecimal68ByPowerOf10_opt for divisor 10**n, generated by mk_tab_opt.py
+unsigned DivPow10Opt_MulCount(unsigned n);
@@ -0,0 +1,237 @@
+#pragma once
+#include <stdint.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// DivPow10Wide<SRC_WORDS, RES_WORDS, NMAX> - family of DivideDecimal68ByPowerOf10-like kernels for wider operands
+//
+// Divide(result, src, n) divides SRC_WORDS-word unsigned integer by 10**n, n in range 0 to NMAX, and returns
+// RES_WORDS-word quotient together with the same rounding code as DivideDecimal68ByPowerOf10:
+// 0 - exact, 1 - remainder below divisor/2, 2 - remainder == divisor/2, 3 - remainder above divisor/2
+//
+// Like in divide_pow10.c, the kernel computes r = floor(src / (10**n/2)), i.e. 2*quotient + upper half bit.
+// Divisor 10**n/2 = 5**n * 2**(n-1), the power of two is shifted out of src and goes to sticky bits,
+// the rest is multiplication of the top RES_WORDS words of x = src >> (n-1) by RES_WORDS-word reciprocal of 5**n,
+// followed by one correction step, that is controlled by the low words of the remainder x - r*5**n.
+//
+// Comments:
+// 1. Reciprocal table is computed at compile time by constexpr code, there is no generator script to rerun
+// 2. When src >= 10**n * 2**(64*RES_WORDS-4) the results are incorrect, but the call is still legal
+//    in a sense that it causes no memory corruptions, traps or any other undefined actions
+// 3. For n=0 or n out of range result is the low RES_WORDS words of src and return value is 0
+template <unsigned SRC_WORDS, unsigned RES_WORDS, unsigned NMAX>
+struct DivPow10Wide {
+  static_assert(SRC_WORDS >= RES_WORDS && RES_WORDS >= 1 && NMAX >= 1, "DivPow10Wide: bad parameters");
+
+  // number of words, sufficient for 2*5**NMAX
+  static constexpr unsigned d_words()
+  {
+    uint64_t d[NMAX / 27 + 2] = {}; // 5**27 < 2**64
+    d[0] = 1;
+    unsigned nw = 1;
+    for (unsigned n = 0; n < NMAX; ++n) {
+      uint64_t carry = 0;
+      for (unsigned i = 0; i < nw; ++i) {
+        uint64_t lo = (d[i] & 0xFFFFFFFF) * 5 + carry;
+        uint64_t hi = (d[i] >> 32) * 5 + (lo >> 32);
+        d[i] = (hi << 32) | (lo & 0xFFFFFFFF);
+        carry = hi >> 32;
+      }
+      if (carry != 0)
+        d[nw++] = carry;
+    }
+    return nw + (d[nw-1] >> 63); // room for 2*5**NMAX
+  }
+  static constexpr unsigned D_WORDS = d_words();
+  enum { SHIFT = 2 }; // e-s
+
+  struct recip_t {
+    uint64_t invF[RES_WORDS]; // floor(2**(64*RES_WORDS+e) / 5**n), where 2**e <= 5**n < 2**(e+1)
+    uint64_t mulF[D_WORDS];   // 5**n
+    unsigned src_shift;       // n-1+s, where s = e-2, so x >> s loses less than 5**n/4
+  };
+
+  struct table_t {
+    recip_t row[NMAX]; // row n-1 serves division by 10**n
+  };
+
+  static constexpr table_t make_table()
+  {
+    table_t tab{};
+    uint64_t d[D_WORDS + 1] = {};
+    d[0] = 1;
+    for (unsigned n = 1; n <= NMAX; ++n) {
+      // d *= 5
+      uint64_t carry = 0;
+      for (unsigned i = 0; i <= D_WORDS; ++i) {
+        uint64_t lo = (d[i] & 0xFFFFFFFF) * 5 + carry;
+        uint64_t hi = (d[i] >> 32) * 5 + (lo >> 32);
+        d[i] = (hi << 32) | (lo & 0xFFFFFFFF);
+        carry = hi >> 32;
+      }
+      unsigned e = 0;
+      for (unsigned i = 0; i < 64 * (D_WORDS + 1); ++i) {
+        if (d[i / 64] >> (i % 64) & 1)
+          e = i;
+      }
+
+      // invF = floor(2**(64*RES_WORDS+e) / d), bit by bit
+      recip_t& r = tab.row[n-1];
+      uint64_t rem[D_WORDS + 1] = {};
+      for (int bit = int(64 * RES_WORDS + e); bit >= 0; --bit) {
+        // rem = rem*2 + numerator bit; rem < 2*d fits
+        for (unsigned i = D_WORDS; i > 0; --i)
+          rem[i] = (rem[i] << 1) | (rem[i-1] >> 63);
+        rem[0] = (rem[0] << 1) | (bit == int(64 * RES_WORDS + e) ? 1 : 0);
+        bool ge = true;
+        for (int i = int(D_WORDS); i >= 0; --i) {
+          if (rem[i] != d[i]) {
+            ge = rem[i] > d[i];
+            break;
+          }
+        }
+        if (ge) {
+          uint64_t borrow = 0;
+          for (unsigned i = 0; i <= D_WORDS; ++i) {
+            uint64_t t = rem[i] - d[i] - borrow;
+            borrow = (rem[i] < d[i]) || (rem[i] - d[i] < borrow);
+            rem[i] = t;
+          }
+          if (bit < int(64 * RES_WORDS))
+            r.invF[bit / 64] |= uint64_t(1) << (bit % 64);
+        }
+      }
+      for (unsigned i = 0; i < D_WORDS; ++i)
+        r.mulF[i] = d[i];
+      r.src_shift = n - 1 + (e - SHIFT);
+    }
+    return tab;
+  }
+
+  static constexpr table_t recip_tab = make_table();
+
+  static inline uint64_t umul128(uint64_t a, uint64_t b, uint64_t* hi)
+  {
+#ifdef _MSC_VER
+    return _umul128(a, b, hi);
+#else
+    unsigned __int128 p = (unsigned __int128)a * b;
+    *hi = (uint64_t)(p >> 64);
+    return (uint64_t)p;
+#endif
+  }
+
+  // W words of src starting at bit pos, zeros beyond the end of src
+  template <unsigned W>
+  static inline void extract(uint64_t out[W], const uint64_t src[SRC_WORDS], unsigned pos)
+  {
+    const unsigned wi = pos / 64, bsh = pos % 64;
+    for (unsigned i = 0; i < W; ++i) {
+      uint64_t lo = wi + i     < SRC_WORDS ? src[wi + i]     : 0;
+      uint64_t hi = wi + i + 1 < SRC_WORDS ? src[wi + i + 1] : 0;
+      out[i] = bsh ? (lo >> bsh) | (hi << (64 - bsh)) : lo;
+    }
+  }
+
+  static int Divide(uint64_t result[RES_WORDS], const uint64_t src[SRC_WORDS], unsigned n)
+  {
+    if (n-1 > NMAX-1) {
+      for (unsigned i = 0; i < RES_WORDS; ++i)
+        result[i] = src[i];
+      return 0;
+    }
+    const recip_t& recip = recip_tab.row[n-1];
+
+    // Multiplication by reciprocal, only the upper half of the product is used
+    uint64_t t[RES_WORDS];
+    extract<RES_WORDS>(t, src, recip.src_shift);
+    uint64_t p[RES_WORDS * 2] = {};
+    for (unsigned i = 0; i < RES_WORDS; ++i) {
+      uint64_t carry = 0;
+      for (unsigned j = 0; j < RES_WORDS; ++j) {
+        uint64_t h;
+        uint64_t l = umul128(t[i], recip.invF[j], &h);
+        l += carry;
+        h += (l < carry);
+        p[i+j] += l;
+        h += (p[i+j] < l);
+        carry = h;
+      }
+      p[i + RES_WORDS] = carry;
+    }
+    uint64_t r[RES_WORDS]; // r = floor(x / 5**n) or one less, invF has 2**(64*RES_WORDS+e), t lacks 2**s
+    for (unsigned i = 0; i < RES_WORDS; ++i) {
+      uint64_t next = i + 1 < RES_WORDS ? p[RES_WORDS + i + 1] : 0;
+      r[i] = (p[RES_WORDS + i] >> SHIFT) | (next << (64 - SHIFT));
+    }
+
+    // Remainder x - r*5**n is below 2*5**n, so D_WORDS low words are sufficient
+    uint64_t rem[D_WORDS];
+    extract<D_WORDS>(rem, src, n - 1);
+    uint64_t borrow = 0;
+    {
+      uint64_t prod[D_WORDS] = {}; // r*5**n, truncated to D_WORDS words
+      for (unsigned i = 0; i < D_WORDS && i < RES_WORDS; ++i) {
+        uint64_t carry = 0;
+        for (unsigned j = 0; i + j < D_WORDS; ++j) {
+          uint64_t h;
+          uint64_t l = umul128(r[i], recip.mulF[j], &h);
+          l += carry;
+          h += (l < carry);
+          prod[i+j] += l;
+          h += (prod[i+j] < l);
+          carry = h;
+        }
+      }
+      for (unsigned i = 0; i < D_WORDS; ++i) {
+        uint64_t d = rem[i] - prod[i];
+        uint64_t b = (rem[i] < prod[i]) | (d < borrow);
+        rem[i] = d - borrow;
+        borrow = b;
+      }
+    }
+
+    // rem >= 5**n -> r underestimated
+    uint64_t sub[D_WORDS];
+    borrow = 0;
+    for (unsigned i = 0; i < D_WORDS; ++i) {
+      uint64_t d = rem[i] - recip.mulF[i];
+      uint64_t b = (rem[i] < recip.mulF[i]) | (d < borrow);
+      sub[i] = d - borrow;
+      borrow = b;
+    }
+    const uint64_t corr_msk = borrow - 1; // all ones when there was no borrow
+    uint64_t steaky = 0;
+    for (unsigned i = 0; i < D_WORDS; ++i)
+      steaky |= rem[i] ^ ((rem[i] ^ sub[i]) & corr_msk);
+    uint64_t carry = corr_msk & 1;
+    for (unsigned i = 0; i < RES_WORDS; ++i) {
+      r[i] += carry;
+      carry = r[i] < carry;
+    }
+
+    // bits of src below n-1 are the low part of the remainder
+    for (unsigned i = 0; i < SRC_WORDS && i * 64 < n - 1; ++i) {
+      const unsigned nb = n - 1 - i * 64;
+      steaky |= src[i] & (nb >= 64 ? ~uint64_t(0) : (uint64_t(1) << nb) - 1);
+    }
+
+    for (unsigned i = 0; i < RES_WORDS; ++i)
+      result[i] = (r[i] >> 1) | (i + 1 < RES_WORDS ? r[i+1] << 63 : 0);
+    return ((int)r[0] & 1) * 2 + (steaky != 0);
+  }
+};
+
+// DivideDecimal144ByPowerOf10 - Divide unsigned integer number by power of ten, 144-digit instantiation
+//
+// Arguments:
+// result - result of division, 4 64-bit words, range [0:10**72-1], Little Endian
+// src    - source (dividend), 8 64-bit words, range [0:10**144-1], Little Endian
+// n      - decimal exponent of the divisor, i.e. divisor=10**n, range 0 to 72
+// Return value: the same as DivideDecimal68ByPowerOf10
+typedef DivPow10Wide<8, 4, 72> DivPow10Wide144;
+inline int DivideDecimal144ByPowerOf10(uint64_t result[4], const uint64_t src[8], unsigned n)
+{
+  return DivPow10Wide144::Divide(result, src, n);
+}
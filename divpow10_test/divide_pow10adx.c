@@ -0,0 +1,4 @@
+// DivideDecimal68ByPowerOf10_adx - the same algorithm as divide_pow10branchless.c,
+// built for CPUs with BMI2 (mulx) and ADX (adcx/adox)
+#define DIVPOW10_BRANCHLESS_ADX 1
+#include "divide_pow10branchless.c"
@@ -1,4 +1,6 @@
 #include "divide_pow10.h"
+#include "divide_pow10_variants.h"
+#include "divide_pow10_cpu.h"
 #include <string.h>
 #ifdef _MSC_VER
 #include <intrin.h>
@@ -6,10 +8,14 @@
 #include <x86intrin.h>
 #endif
 
-#if REPORT_UNDERFLOWS
-uint8_t gl_underflow;
-#endif
+#ifndef DIVPOW10_BRANCHLESS_ADX
+// Default build - plain mul and adc/sbb
 
+#define DIVPOW10_BRANCHLESS_NAME   DivideDecimal68ByPowerOf10_branchless
+#define DIVPOW10_BRANCHLESS_DIVMOD DivModDecimal68ByPowerOf10_branchless
+#define DIVPOW10_BRANCHLESS_X2     DivideDecimal68ByPowerOf10_branchless_x2
+#define DIVPOW10_BRANCHLESS_X4     DivideDecimal68ByPowerOf10_branchless_x4
+#define DIVPOW10_BRANCHLESS_TARGET
 
 #ifdef _MSC_VER
 
@@ -30,7 +36,226 @@ static inline uint64_t UMUL128(uint64_t a, uint64_t b, uint64_t* xh) {
 }
 #endif
 
-// DivideDecimal68ByPowerOf10 - Divide unsigned integer number by power of ten
+#else
+// BMI2/ADX build, see divide_pow10adx.c
+// mulx does not touch flags, so multiplications can be scheduled in the middle of the carry chains.
+// The remainder and its comparison with the divisor are two interleaved carry chains on CF (adcx) and OF (adox),
+// compilers don't emit adcx/adox for _addcarryx_u64, so with GNU C the chains are written in inline asm.
+
+#define DIVPOW10_BRANCHLESS_NAME   DivideDecimal68ByPowerOf10_adx
+#define DIVPOW10_BRANCHLESS_DIVMOD DivModDecimal68ByPowerOf10_adx
+#define DIVPOW10_BRANCHLESS_X2     DivideDecimal68ByPowerOf10_adx_x2
+#define DIVPOW10_BRANCHLESS_X4     DivideDecimal68ByPowerOf10_adx_x4
+#ifdef _MSC_VER
+#define DIVPOW10_BRANCHLESS_TARGET
+#else
+#define DIVPOW10_BRANCHLESS_TARGET __attribute__((target("bmi2,adx")))
+#define DIVPOW10_BRANCHLESS_ASM 1
+#endif
+
+static inline DIVPOW10_BRANCHLESS_TARGET uint64_t UMULH(uint64_t a, uint64_t b) {
+ unsigned long long xh;
+ _mulx_u64(a, b, &xh);
+ return xh;
+}
+
+static inline DIVPOW10_BRANCHLESS_TARGET uint64_t UMUL128(uint64_t a, uint64_t b, uint64_t* xh) {
+ unsigned long long h;
+ uint64_t l = _mulx_u64(a, b, &h);
+ *xh = h;
+ return l;
+}
+#endif
+
+#define ADDCARRY(c, a, b, out)     _addcarry_u64(c, a, b, (unsigned long long*)(out))
+#define SUBBORROW(c, a, b, out)    _subborrow_u64(c, a, b, (unsigned long long*)(out))
+
+enum { NMAX = 34 };
+
+// Rows are 32 bytes, the table is aligned to cache line, so one division reads one line
+DIVPOW10_CACHE_ALIGNED static const struct {
+  uint64_t mulF_l;  // 10**n / 2
+  uint64_t mulF_hx; // mulF_h | srcH_offs << 56, mulF_h < 2**48
+  uint64_t invF_l;  // 2**(srcH_offs*8+130) / mulF, srcH_offs = maximal number of bits in src[] rounded up to the whole octet - 128 / 8
+  uint64_t invF_h;
+} recip_tab[NMAX] = {
+ { 0x0000000000000005, 0x0000000000000000, 0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCC }, //  1
+ { 0x0000000000000032, 0x0000000000000000, 0x47AE147AE147AE14, 0x147AE147AE147AE1 }, //  2
+ { 0x00000000000001F4, 0x0000000000000000, 0xED916872B020C49B, 0x020C49BA5E353F7C }, //  3
+ { 0x0000000000001388, 0x0000000000000000, 0x4AF4F0D844D013A9, 0x00346DC5D6388659 }, //  4
+ { 0x000000000000C350, 0x0100000000000000, 0x187E7C06E19B90EA, 0x053E2D6238DA3C21 }, //  5
+ { 0x000000000007A120, 0x0100000000000000, 0xB5A63F9A49C2C1B1, 0x008637BD05AF6C69 }, //  6
+ { 0x00000000004C4B40, 0x0200000000000000, 0xC3D32907604691B4, 0x0D6BF94D5E57A42B }, //  7
+ { 0x0000000002FAF080, 0x0200000000000000, 0xF9FB841A566D74F8, 0x015798EE2308C39D }, //  8
+ { 0x000000001DCD6500, 0x0200000000000000, 0x65CC5A02A23E254C, 0x00225C17D04DAD29 }, //  9
+ { 0x000000012A05F200, 0x0300000000000000, 0xFAD5CD10396A2134, 0x036F9BFB3AF7B756 }, // 10
+ { 0x0000000BA43B7400, 0x0300000000000000, 0x7F7BC7B4D28A9CEB, 0x0057F5FF85E59255 }, // 11
+ { 0x000000746A528800, 0x0400000000000000, 0xBF93F87B7442E45D, 0x08CBCCC096F5088C }, // 12
+ { 0x0000048C27395000, 0x0400000000000000, 0x132865A5F206B06F, 0x00E12E13424BB40E }, // 13
+ { 0x00002D79883D2000, 0x0400000000000000, 0x01EA70909833DE71, 0x0016849B86A12B9B }, // 14
+ { 0x0001C6BF52634000, 0x0500000000000000, 0x643E74DC052FD828, 0x024075F3DCEAC2B3 }, // 15
+ { 0x0011C37937E08000, 0x0500000000000000, 0x56D30BAF9A1E626A, 0x0039A5652FB11378 }, // 16
+ { 0x00B1A2BC2EC50000, 0x0600000000000000, 0x484DF7F5CFD6A43E, 0x05C3BD5191B525A2 }, // 17
+ { 0x06F05B59D3B20000, 0x0600000000000000, 0x073AFF322E62439F, 0x009392EE8E921D5D }, // 18
+ { 0x4563918244F40000, 0x0700000000000000, 0x52B31E9E3D06C32E, 0x0EC1E4A7DB69561A }, // 19
+ { 0xB5E3AF16B1880000, 0x0700000000000002, 0xD511E976394D79EB, 0x0179CA10C9242235 }, // 20
+ { 0x1AE4D6E2EF500000, 0x070000000000001B, 0xFBB4FDBF05BAF297, 0x0025C768141D369E }, // 21
+ { 0x0CF064DD59200000, 0x080000000000010F, 0xC54C931A2C4B758C, 0x03C7240202EBDCB2 }, // 22
+ { 0x8163F0A57B400000, 0x0800000000000A96, 0x13BADB829E078BC1, 0x0060B6CD004AC945 }, // 23
+ { 0x0DE76676D0800000, 0x09000000000069E1, 0x2C4926A967279354, 0x09ABE14CD44753B5 }, // 24
+ { 0x8B0A00A425000000, 0x09000000000422CA, 0x513A83DDBD83F522, 0x00F79687AED3EEC5 }, // 25
+ { 0x6E64066972000000, 0x0900000000295BE9, 0xBB52A6C95FC06550, 0x0018C240C4AECB13 }, // 26
+ { 0x4FE8401E74000000, 0x0A000000019D971E, 0x21DD7A89933D54D1, 0x0279D346DE4781F9 }, // 27
+ { 0x1F12813088000000, 0x0A0000001027E72F, 0x8362F2A75B862214, 0x003F61ED7CA0C032 }, // 28
+ { 0x36B90BE550000000, 0x0B000000A18F07D7, 0xF04B7722C09D0219, 0x065697BFA9ACD1D9 }, // 29
+ { 0x233A76F520000000, 0x0B0000064F964E68, 0x31A1258379A94D02, 0x00A2425FF75E14FC }, // 30
+ { 0x6048A59340000000, 0x0B00003F1BDF1011, 0x9E901D59F290EE19, 0x001039D66589687F }, // 31
+ { 0xC2D677C080000000, 0x0C00027716B6A0AD, 0x74CFBC31DB4B0295, 0x019F623D5A8A7329 }, // 32
+ { 0x9C60AD8500000000, 0x0C0018A6E32246C9, 0x587B2C6B62BAB375, 0x002989D2EF743EB7 }, // 33
+ { 0x1BC6C73200000000, 0x0D00F684DF56C3E0, 0xA5EAD789DF785889, 0x042761E4BED31255 }, // 34
+};
+
+enum { LANES_MAX = 4 };
+
+// Loops over lanes are unrolled, so the state of every lane is in registers
+#if defined(__GNUC__) && !defined(__clang__)
+#define FOR_EACH_LANE(i, K) _Pragma("GCC unroll 4") for (i = 0; i < K; ++i)
+#elif defined(__clang__)
+#define FOR_EACH_LANE(i, K) _Pragma("unroll") for (i = 0; i < K; ++i)
+#else
+#define FOR_EACH_LANE(i, K) for (i = 0; i < K; ++i)
+#endif
+
+// divide_branchless_lanes - common body of DIVPOW10_BRANCHLESS_NAME, DIVPOW10_BRANCHLESS_DIVMOD and the multi-lane entries
+// Divides K independent src[i] by 10**n[i], K in range 1 to LANES_MAX, every n[i] in range 1 to 34,
+// remainder=0 when the caller does not need it.
+// Every step is done for all lanes before the next one starts: both table rows are loaded first, then the
+// multiplications of all lanes follow each other, so the chain of one lane runs while another waits for its multiplier.
+static DIVPOW10_FORCEINLINE DIVPOW10_BRANCHLESS_TARGET void divide_branchless_lanes(
+  uint64_t result[][2], uint64_t remainder[][2], int ret[], const uint64_t src[][4], const unsigned n[], const unsigned K)
+{
+  uint64_t srcH[LANES_MAX], srcL[LANES_MAX], invF_h[LANES_MAX], invF_l[LANES_MAX], mulF_h[LANES_MAX], mulF_l[LANES_MAX];
+  uint64_t r0[LANES_MAX], r1[LANES_MAX], mx_l[LANES_MAX], mx_h[LANES_MAX], src1[LANES_MAX];
+  unsigned i;
+  uint8_t carry;
+
+  FOR_EACH_LANE(i, K) {
+    // Fetch upper 128 bits of the src[]
+    // Attention this code works only on byte-addressable Little Endian machines!
+    const uint64_t mulF_hx = recip_tab[n[i]-1].mulF_hx;
+    const unsigned srcH_offs = (unsigned)(mulF_hx >> 56);
+    memcpy(&srcH[i], (const char*)src[i] + srcH_offs + 8, sizeof(srcH[i]));
+    memcpy(&srcL[i], (const char*)src[i] + srcH_offs + 0, sizeof(srcL[i]));
+    invF_h[i] = recip_tab[n[i]-1].invF_h;
+    invF_l[i] = recip_tab[n[i]-1].invF_l;
+    mulF_h[i] = mulF_hx & (((uint64_t)1 << 56) - 1);
+    mulF_l[i] = recip_tab[n[i]-1].mulF_l;
+  }
+
+  FOR_EACH_LANE(i, K) {
+    const uint64_t r0a = UMULH(srcL[i], invF_h[i]) + UMULH(srcH[i], invF_l[i]);
+    r0[i] = UMUL128(srcH[i], invF_h[i], &r1[i]);
+    carry = ADDCARRY(0,     r0[i], r0a, &r0[i]);
+    carry = ADDCARRY(carry, r1[i], 0,   &r1[i]);
+    r0[i] = (r0[i] >> 2) | (r1[i] << (64-2));
+    r1[i] = (r1[i] >> 2);
+  }
+
+  FOR_EACH_LANE(i, K) {
+    src1[i] = src[i][1] - (r1[i]*mulF_l[i] + r0[i]*mulF_h[i]);
+    mx_l[i] = UMUL128(r0[i], mulF_l[i], &mx_h[i]);
+  }
+
+  FOR_EACH_LANE(i, K) {
+    const uint64_t mulF_li = mulF_l[i], mulF_hi = mulF_h[i];
+    uint64_t r0i = r0[i], r1i = r1[i];
+    uint64_t src0 = src[i][0], src1i = src1[i];
+#ifndef DIVPOW10_BRANCHLESS_ASM
+    uint8_t borrow;
+    borrow = SUBBORROW(0,      src0,  mx_l[i], &src0);
+    borrow = SUBBORROW(borrow, src1i, mx_h[i], &src1i);
+    // remainder in src1:src0
+    const uint64_t rem0 = src0, rem1 = src1i;
+
+    borrow = SUBBORROW(0,      src0,  mulF_li, &src0);
+    borrow = SUBBORROW(borrow, src1i, mulF_hi, &src1i);
+    const uint8_t no_borrow = 1 - borrow;
+    borrow = SUBBORROW(borrow, r0i, (uint64_t)-1, &r0i);
+    borrow = SUBBORROW(borrow, r1i, (uint64_t)-1, &r1i);
+#else
+    // CF chain: rem = src - mx, as src + ~mx + 1.
+    // OF chain: rem - mulF, as rem + (2**128 - mulF), carry out = rem >= mulF, then r += carry.
+    // mulF_l = 10**n/2 mod 2**64 is never 0 for n <= 34, so 2**128 - mulF = (~mulF_h : -mulF_l)
+    uint64_t rem0 = src0, rem1 = src1i, zero;
+    uint8_t no_borrow;
+    __asm__ (
+      "xorl   %k[zero], %k[zero]\n\t" // CF = OF = 0
+      "stc\n\t"
+      "adcx   %[nmx_l], %[rem0]\n\t"
+      "movq   %[rem0], %[src0]\n\t"
+      "adox   %[ngF_l], %[src0]\n\t"
+      "adcx   %[nmx_h], %[rem1]\n\t"
+      "movq   %[rem1], %[src1]\n\t"
+      "adox   %[ngF_h], %[src1]\n\t"
+      "seto   %[nb]\n\t"
+      "adox   %[zero], %[r0]\n\t"
+      "adox   %[zero], %[r1]"
+      : [rem0] "+&r"(rem0), [rem1] "+&r"(rem1), [src0] "=&r"(src0), [src1] "=&r"(src1i),
+        [r0] "+&r"(r0i), [r1] "+&r"(r1i), [zero] "=&r"(zero), [nb] "=&r"(no_borrow)
+      : [nmx_l] "r"(~mx_l[i]), [nmx_h] "r"(~mx_h[i]), [ngF_l] "rm"(0 - mulF_li), [ngF_h] "rm"(~mulF_hi)
+      : "cc");
+    (void)zero;
+#endif
+    // remainder in rem1:rem0, remainder - mulF in src1:src0
+    const uint64_t keep_msk = (uint64_t)no_borrow - 1; // remainder < mulF, r1:r0 is final
+    #if REPORT_UNDERFLOWS
+    gl_underflow = no_borrow;
+    #endif
+    const int steaky = ((rem0|rem1) != 0) & ((src0|src1i) != 0);
+
+    if (remainder) {
+      // r1:r0 is 2*quotient, odd value leaves the upper half of divisor in the remainder
+      const uint64_t odd_msk = 0 - (r0i & 1);
+      uint64_t rm0 = (rem0 & keep_msk) | (src0 & ~keep_msk);
+      uint64_t rm1 = (rem1 & keep_msk) | (src1i & ~keep_msk);
+      carry = ADDCARRY(0,     rm0, mulF_li & odd_msk, &rm0);
+      carry = ADDCARRY(carry, rm1, mulF_hi & odd_msk, &rm1);
+      remainder[i][0] = rm0;
+      remainder[i][1] = rm1;
+    }
+
+    result[i][0] = (r1i << 63) | (r0i >> 1);
+    result[i][1] = r1i >> 1;
+    // return (r0 + r0 + steaky) & 3;
+    ret[i] = ((int)r0i & 1) *2 + steaky;
+  }
+  (void)carry;
+}
+
+// divide_branchless_row - one lane of divide_branchless_lanes, n in range 1 to 34
+static DIVPOW10_FORCEINLINE DIVPOW10_BRANCHLESS_TARGET int divide_branchless_row(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n)
+{
+  int ret;
+  divide_branchless_lanes((uint64_t (*)[2])result, (uint64_t (*)[2])remainder, &ret, (const uint64_t (*)[4])src, &n, 1);
+  return ret;
+}
+
+static DIVPOW10_FORCEINLINE DIVPOW10_BRANCHLESS_TARGET int divide_branchless(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n)
+{
+  #if REPORT_UNDERFLOWS
+  gl_underflow = 0;
+  #endif
+  if (n-1 > NMAX-1) {
+    result[0] = src[0];
+    result[1] = src[1];
+    if (remainder)
+      remainder[0] = remainder[1] = 0;
+    return 0;
+  }
+  return divide_branchless_row(result, remainder, src, n);
+}
+
+// DivideDecimal68ByPowerOf10_branchless - Divide unsigned integer number by power of ten
 //
 // Arguments:
 // result - result of division, 2 64-bit words, range [0:10**34-1], Little Endian
@@ -45,105 +270,93 @@ static inline uint64_t UMUL128(uint64_t a, uint64_t b, uint64_t* xh) {
 // 1. It works only on byte-addressable Little Endian machines
 // 2. When src >= 10**n * 2**112 the results are incorrect, but the call is still legal
 //    in a sense that it causes no memory corruptions, traps or any other undefined actions
-int DivideDecimal68ByPowerOf10(uint64_t result[2], const uint64_t src[4], unsigned n)
+DIVPOW10_BRANCHLESS_TARGET int DIVPOW10_BRANCHLESS_NAME(uint64_t result[2], const uint64_t src[4], unsigned n)
 {
-  #if REPORT_UNDERFLOWS
-  gl_underflow = 0;
-  #endif
-  enum { NMAX = 34 };
+  return divide_branchless(result, 0, src, n);
+}
 
-  if (n-1 > NMAX-1) {
-    result[0] = src[0];
-    result[1] = src[1];
-    return 0;
+// DivModDecimal68ByPowerOf10_branchless - DivideDecimal68ByPowerOf10_branchless that also returns the remainder
+// See DivModDecimal68ByPowerOf10 in divide_pow10.h
+DIVPOW10_BRANCHLESS_TARGET int DIVPOW10_BRANCHLESS_DIVMOD(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n)
+{
+  return divide_branchless(result, remainder, src, n);
+}
+
+// DivideDecimal68ByPowerOf10_branchless_x2 - two independent DivideDecimal68ByPowerOf10_branchless in one call
+// See DivideDecimal68ByPowerOf10_x2 in divide_pow10.h
+// One branch for all lanes, n=0 and n out of range go to the per-lane path. Otherwise the lanes go through
+// divide_branchless_lanes, that interleaves their chains of multiplications step by step.
+// result[], ret[] and src[] are restrict: without it a store of one lane may alias src[] of the next lane,
+// and loads of the next lane can't be moved above the stores of the previous one.
+DIVPOW10_BRANCHLESS_TARGET void DIVPOW10_BRANCHLESS_X2(uint64_t result[DIVPOW10_RESTRICT 2][2], int ret[DIVPOW10_RESTRICT 2], const uint64_t src[DIVPOW10_RESTRICT 2][4], const unsigned n[2])
+{
+  const unsigned n0 = n[0], n1 = n[1];
+  if ((n0-1 > NMAX-1) | (n1-1 > NMAX-1)) {
+    ret[0] = divide_branchless(result[0], 0, src[0], n0);
+    ret[1] = divide_branchless(result[1], 0, src[1], n1);
+    return;
   }
+  divide_branchless_lanes(result, 0, ret, src, n, 2);
+}
 
-  static const struct {
-    int32_t  srcH_offs; // maximal number of bits in src[] rounded up to the whole octet - 128 / 8
-    uint32_t rsrv;
-    uint64_t mulF_l;  // 10**n / 2
-    uint64_t mulF_h;
-    uint64_t invF_l;  // 2**(srcH_offs*8+130) / mulF
-    uint64_t invF_h;
-  } recip_tab[NMAX] = {
-   { 0, 0, 0x0000000000000005, 0x0000000000000000, 0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCC }, //  1
-   { 0, 0, 0x0000000000000032, 0x0000000000000000, 0x47AE147AE147AE14, 0x147AE147AE147AE1 }, //  2
-   { 0, 0, 0x00000000000001F4, 0x0000000000000000, 0xED916872B020C49B, 0x020C49BA5E353F7C }, //  3
-   { 0, 0, 0x0000000000001388, 0x0000000000000000, 0x4AF4F0D844D013A9, 0x00346DC5D6388659 }, //  4
-   { 1, 0, 0x000000000000C350, 0x0000000000000000, 0x187E7C06E19B90EA, 0x053E2D6238DA3C21 }, //  5
-   { 1, 0, 0x000000000007A120, 0x0000000000000000, 0xB5A63F9A49C2C1B1, 0x008637BD05AF6C69 }, //  6
-   { 2, 0, 0x00000000004C4B40, 0x0000000000000000, 0xC3D32907604691B4, 0x0D6BF94D5E57A42B }, //  7
-   { 2, 0, 0x0000000002FAF080, 0x0000000000000000, 0xF9FB841A566D74F8, 0x015798EE2308C39D }, //  8
-   { 2, 0, 0x000000001DCD6500, 0x0000000000000000, 0x65CC5A02A23E254C, 0x00225C17D04DAD29 }, //  9
-   { 3, 0, 0x000000012A05F200, 0x0000000000000000, 0xFAD5CD10396A2134, 0x036F9BFB3AF7B756 }, // 10
-   { 3, 0, 0x0000000BA43B7400, 0x0000000000000000, 0x7F7BC7B4D28A9CEB, 0x0057F5FF85E59255 }, // 11
-   { 4, 0, 0x000000746A528800, 0x0000000000000000, 0xBF93F87B7442E45D, 0x08CBCCC096F5088C }, // 12
-   { 4, 0, 0x0000048C27395000, 0x0000000000000000, 0x132865A5F206B06F, 0x00E12E13424BB40E }, // 13
-   { 4, 0, 0x00002D79883D2000, 0x0000000000000000, 0x01EA70909833DE71, 0x0016849B86A12B9B }, // 14
-   { 5, 0, 0x0001C6BF52634000, 0x0000000000000000, 0x643E74DC052FD828, 0x024075F3DCEAC2B3 }, // 15
-   { 5, 0, 0x0011C37937E08000, 0x0000000000000000, 0x56D30BAF9A1E626A, 0x0039A5652FB11378 }, // 16
-   { 6, 0, 0x00B1A2BC2EC50000, 0x0000000000000000, 0x484DF7F5CFD6A43E, 0x05C3BD5191B525A2 }, // 17
-   { 6, 0, 0x06F05B59D3B20000, 0x0000000000000000, 0x073AFF322E62439F, 0x009392EE8E921D5D }, // 18
-   { 7, 0, 0x4563918244F40000, 0x0000000000000000, 0x52B31E9E3D06C32E, 0x0EC1E4A7DB69561A }, // 19
-   { 7, 0, 0xB5E3AF16B1880000, 0x0000000000000002, 0xD511E976394D79EB, 0x0179CA10C9242235 }, // 20
-   { 7, 0, 0x1AE4D6E2EF500000, 0x000000000000001B, 0xFBB4FDBF05BAF297, 0x0025C768141D369E }, // 21
-   { 8, 0, 0x0CF064DD59200000, 0x000000000000010F, 0xC54C931A2C4B758C, 0x03C7240202EBDCB2 }, // 22
-   { 8, 0, 0x8163F0A57B400000, 0x0000000000000A96, 0x13BADB829E078BC1, 0x0060B6CD004AC945 }, // 23
-   { 9, 0, 0x0DE76676D0800000, 0x00000000000069E1, 0x2C4926A967279354, 0x09ABE14CD44753B5 }, // 24
-   { 9, 0, 0x8B0A00A425000000, 0x00000000000422CA, 0x513A83DDBD83F522, 0x00F79687AED3EEC5 }, // 25
-   { 9, 0, 0x6E64066972000000, 0x0000000000295BE9, 0xBB52A6C95FC06550, 0x0018C240C4AECB13 }, // 26
-   {10, 0, 0x4FE8401E74000000, 0x00000000019D971E, 0x21DD7A89933D54D1, 0x0279D346DE4781F9 }, // 27
-   {10, 0, 0x1F12813088000000, 0x000000001027E72F, 0x8362F2A75B862214, 0x003F61ED7CA0C032 }, // 28
-   {11, 0, 0x36B90BE550000000, 0x00000000A18F07D7, 0xF04B7722C09D0219, 0x065697BFA9ACD1D9 }, // 29
-   {11, 0, 0x233A76F520000000, 0x000000064F964E68, 0x31A1258379A94D02, 0x00A2425FF75E14FC }, // 30
-   {11, 0, 0x6048A59340000000, 0x0000003F1BDF1011, 0x9E901D59F290EE19, 0x001039D66589687F }, // 31
-   {12, 0, 0xC2D677C080000000, 0x0000027716B6A0AD, 0x74CFBC31DB4B0295, 0x019F623D5A8A7329 }, // 32
-   {12, 0, 0x9C60AD8500000000, 0x000018A6E32246C9, 0x587B2C6B62BAB375, 0x002989D2EF743EB7 }, // 33
-   {13, 0, 0x1BC6C73200000000, 0x0000F684DF56C3E0, 0xA5EAD789DF785889, 0x042761E4BED31255 }, // 34
-  };
-
-  // Fetch upper 128 bits of the src[]
-  // Attention this code works only on byte-addressable Little Endian machines!
-  const int srcH_offs = recip_tab[n-1].srcH_offs;
-  uint64_t srcH, srcL;
-  memcpy(&srcH, (char*)src + srcH_offs + 8, sizeof(srcH));
-  memcpy(&srcL, (char*)src + srcH_offs + 0, sizeof(srcL));
-
-  const uint64_t invF_h = recip_tab[n-1].invF_h;
-  const uint64_t invF_l = recip_tab[n-1].invF_l;
-  const uint64_t mulF_h = recip_tab[n-1].mulF_h;
-  const uint64_t mulF_l = recip_tab[n-1].mulF_l;
-
-  uint64_t r0a = UMULH(srcL, invF_h) + UMULH(srcH, invF_l);
-  uint64_t r1;
-  uint64_t r0 = UMUL128(srcH, invF_h, &r1);
-  uint8_t carry;
-  carry = _addcarry_u64(0,     r0, r0a, &r0);
-  carry = _addcarry_u64(carry, r1, 0,   &r1);
-  r0 = (r0 >> 2) | (r1 << (64-2));
-  r1 = (r1 >> 2);
-
-  uint64_t src1 = src[1] - (r1*mulF_l + r0*mulF_h);
-  uint64_t mx_h;
-  uint64_t mx_l = UMUL128(r0, mulF_l, &mx_h);
-  uint8_t borrow;
-  uint64_t src0 = src[0];
-  borrow = _subborrow_u64(0,      src0, mx_l, &src0);
-  borrow = _subborrow_u64(borrow, src1, mx_h, &src1);
-  // remainder in src1:src0
-  int steaky = (src0|src1) != 0;
-
-  borrow = _subborrow_u64(0,      src0, mulF_l, &src0);
-  borrow = _subborrow_u64(borrow, src1, mulF_h, &src1);
-  #if REPORT_UNDERFLOWS
-  gl_underflow = 1-borrow;
-  #endif
-  borrow = _subborrow_u64(borrow, r0,  (uint64_t)-1, &r0);
-  borrow = _subborrow_u64(borrow, r1,  (uint64_t)-1, &r1);
-  steaky &= (src0|src1) != 0;
-
-  result[0] = (r1 << 63) | (r0 >> 1);
-  result[1] = r1 >> 1;
-  // return (r0 + r0 + steaky) & 3;
-  return ((int)r0 & 1) *2 + steaky;
+// DivideDecimal68ByPowerOf10_branchless_x4 - four independent DivideDecimal68ByPowerOf10_branchless in one call
+// See DivideDecimal68ByPowerOf10_x4 in divide_pow10.h
+DIVPOW10_BRANCHLESS_TARGET void DIVPOW10_BRANCHLESS_X4(uint64_t result[DIVPOW10_RESTRICT 4][2], int ret[DIVPOW10_RESTRICT 4], const uint64_t src[DIVPOW10_RESTRICT 4][4], const unsigned n[4])
+{
+  const unsigned n0 = n[0], n1 = n[1], n2 = n[2], n3 = n[3];
+  if ((n0-1 > NMAX-1) | (n1-1 > NMAX-1) | (n2-1 > NMAX-1) | (n3-1 > NMAX-1)) {
+    ret[0] = divide_branchless(result[0], 0, src[0], n0);
+    ret[1] = divide_branchless(result[1], 0, src[1], n1);
+    ret[2] = divide_branchless(result[2], 0, src[2], n2);
+    ret[3] = divide_branchless(result[3], 0, src[3], n3);
+    return;
+  }
+  divide_branchless_lanes(result, 0, ret, src, n, 4);
+}
+
+#ifndef DIVPOW10_BRANCHLESS_ADX
+// DivideDecimal68ByPowerOf10 and the other entries of divide_pow10.h are the default build of branchless.
+// Measured by min of 400 runs over 4096 calls with random n in 1..34 on Xeon with BMI2, ADX and AVX512-IFMA,
+// throughput / latency in ns per call:
+//   branchless              6.7-7.0 / 19.0-19.7
+//   adx (mulx, adcx/adox)   7.7-8.0 / 20.2-21.0
+//   adx with mulx only      7.0-7.3 / 19.8-20.5
+// mulx and the dual carry chains don't shorten the chain of multiplications, that is the critical path,
+// and cost extra instructions. branchless needs no extension and no other variant beats it on any host measured,
+// so there is nothing to choose at load time and the entries are bound at link time, without a resolver
+// and without an indirect call. adx is still built and can be benchmarked by name.
+#if defined(__GNUC__) && defined(__ELF__)
+
+int DivideDecimal68ByPowerOf10(uint64_t result[2], const uint64_t src[4], unsigned n)
+  __attribute__((alias("DivideDecimal68ByPowerOf10_branchless")));
+int DivModDecimal68ByPowerOf10(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n)
+  __attribute__((alias("DivModDecimal68ByPowerOf10_branchless")));
+void DivideDecimal68ByPowerOf10_x2(uint64_t result[2][2], int ret[2], const uint64_t src[2][4], const unsigned n[2])
+  __attribute__((alias("DivideDecimal68ByPowerOf10_branchless_x2")));
+void DivideDecimal68ByPowerOf10_x4(uint64_t result[4][2], int ret[4], const uint64_t src[4][4], const unsigned n[4])
+  __attribute__((alias("DivideDecimal68ByPowerOf10_branchless_x4")));
+
+#else
+
+int DivideDecimal68ByPowerOf10(uint64_t result[2], const uint64_t src[4], unsigned n)
+{
+  return divide_branchless(result, 0, src, n);
+}
+
+int DivModDecimal68ByPowerOf10(uint64_t result[2], uint64_t remainder[2], const uint64_t src[4], unsigned n)
+{
+  return divide_branchless(result, remainder, src, n);
+}
+
+void DivideDecimal68ByPowerOf10_x2(uint64_t result[2][2], int ret[2], const uint64_t src[2][4], const unsigned n[2])
+{
+  DivideDecimal68ByPowerOf10_branchless_x2(result, ret, src, n);
 }
+
+void DivideDecimal68ByPowerOf10_x4(uint64_t result[4][2], int ret[4], const uint64_t src[4][4], const unsigned n[4])
+{
+  DivideDecimal68ByPowerOf10_branchless_x4(result, ret, src, n);
+}
+
+#endif
+#endif
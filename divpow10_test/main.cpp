@@ -5,12 +5,34 @@
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <utility>
+#include <thread>
+#include <atomic>
+#include <map>
+#include <string>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 extern "C" {
 #include "divide_pow10_reference.h"
 #include "divide_pow10.h"
+#include "divide_pow10_variants.h"
+#include "divide_pow10_cpu.h"
 };
+#include "divide_pow10_fixed.h"
+#include "divide_pow10_wide.h"
 #include "multiprec_ut.h"
+#include "perf_counters.h"
 
 struct div_rem_t {
   mp_uint128_t div;
@@ -18,22 +40,185 @@ struct div_rem_t {
 };
 
 static bool result_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps);
-static void time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter);
+static bool divmod_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps);
+static bool round_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps);
+static void round_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter);
+static bool batch_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps);
+static bool lanes_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps);
+static void lanes_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter);
+static void bucket_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter);
+static bool column_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps);
+static void column_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter);
+static bool fixed_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps);
+static void fixed_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter);
+static void cold_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter);
+struct bench_result_t {
+  const char* scenario;
+  std::string variant;
+  unsigned    n_min, n_max;
+  const char* metric;    // "rThr" or "Lat"
+  double      median_ns; // ns/call, over nIter iterations
+  double      min_ns;
+  double      max_ns;
+  double      perf[PerfCounters::MAX_EVENTS]; // events per call, -1 when not available
+};
+static void time_test(std::vector<bench_result_t>* results, const char* scenario, const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter);
+static bool compare_variants(std::vector<bench_result_t>& results, const char* scenario, const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps, int nIter);
+static bool write_results(const char* fname, bool json, const std::vector<bench_result_t>& results, int nInps, int nIter);
+static void mt_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter, int nThreads);
+static bool fuzz_test(uint64_t nCases, uint64_t seed, int nThreads);
+static void per_n_time_test(const mp_uint256_t* inpv, const div_rem_t* outv, int nInps, int nIter);
+static bool dec32_test(int nInps, int nIter);
+static bool wide_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps);
+static bool dec144_test(int nInps, int nIter);
+static bool normalize_test(int nInps, int nIter);
 static void InitPow10Table(void);
+static void InitFixedTables(void);
 
 static mp_uint128_t pow10_tab[35];
+static mp_uint256_t pow10_wide_tab[69];
+
+static const struct {
+  const char* name;
+  DivideDecimal68ByPowerOf10_fn fn;
+  DivModDecimal68ByPowerOf10_fn divmod; // 0 - not available
+} variants_tab[] = {
+  { "auto",       DivideDecimal68ByPowerOf10,            DivModDecimal68ByPowerOf10 },
+  { "generic",    DivideDecimal68ByPowerOf10_generic,    DivModDecimal68ByPowerOf10_generic },
+  { "branchless", DivideDecimal68ByPowerOf10_branchless, DivModDecimal68ByPowerOf10_branchless },
+  { "srcshift",   DivideDecimal68ByPowerOf10_srcshift,   DivModDecimal68ByPowerOf10_srcshift },
+  { "adx",        DivideDecimal68ByPowerOf10_adx,        DivModDecimal68ByPowerOf10_adx },
+  { "opt",        DivideDecimal68ByPowerOf10_opt,        DivModDecimal68ByPowerOf10_opt },
+  { "reference",  DivideDecimal68ByPowerOf10_ref,        0 }, // compared by "all" only
+  { "fastref",    DivideDecimal68ByPowerOf10_fastref,    0 },
+};
+// Input distributions. Every scenario is run over n_ranges[], except currency, that has its own scale histogram
+enum { SCEN_RANDOM, SCEN_CORRECTION, SCEN_TIES, SCEN_SMALL, SCEN_CURRENCY, SCEN_TRACE };
+static const struct {
+  int         id;
+  const char* name;
+  const char* descr;
+} scenario_tab[] = {
+  { SCEN_RANDOM,     "random",     "uniform and log-distributed quotients, uniform remainders" },
+  { SCEN_CORRECTION, "correction", "every other src is an exact multiple of 10**n/2, generic corrects the quotient on half of calls for n >= 11, quarter at n = 10, rarely for n <= 9" },
+  { SCEN_TIES,       "ties",       "remainder is exactly 10**n/2" },
+  { SCEN_SMALL,      "small",      "quotients of up to 6 digits" },
+  { SCEN_CURRENCY,   "currency",   "scale histogram of rescaling of currency amounts and rates" },
+  { SCEN_TRACE,      "trace",      "calls recorded by DivideDecimal68ByPowerOf10_Traced, see --trace" },
+};
+
+// n of SCEN_CURRENCY, each entry has the same probability:
+// 2 - cents from 4-digit prices, 4 and 6 - from rates, 8 and 10 - from products of rates, tail - other
+static const unsigned char currency_n_tab[20] = {
+  2, 2, 2, 2, 2, 2, 2, 2, 4, 4, 4, 4, 6, 6, 6, 8, 8, 10, 16, 24 };
+
+static DivideDecimal68ByPowerOf10_fn divide_fn = DivideDecimal68ByPowerOf10; // implementation under test
+static DivModDecimal68ByPowerOf10_fn divmod_fn = DivModDecimal68ByPowerOf10;
+static const char* variant_name = "auto"; // name of divide_fn in variants_tab
+static PerfCounters perf; // counters around throughput and latency loops, see --perf-raw
+static uint64_t perfRaw[PerfCounters::MAX_RAW];
+static int      nPerfRaw = 0;
+static void print_perf(const char* prefix, const PerfCounters& pc, double nCalls);
+static bool load_trace(const char* fname, std::vector<mp_uint256_t>& inpv, std::vector<unsigned>& expv, std::vector<div_rem_t>& outv, int maxRecords);
 
 int main(int argz, char**argv)
 {
+  const char* jsonFile = 0;
+  const char* csvFile  = 0;
+  const char* scenarioName = "random";
+  const char* traceFile  = 0;
+  const char* recordFile = 0;
+  double   fuzzCases = 0;
+  uint64_t fuzzSeed  = 0;
+  bool     fuzzSeedSet = false;
+  int nPos = 1;
+  for (int i = 1; i < argz; ++i) {
+    if (strncmp(argv[i], "--json=", 7) == 0)
+      jsonFile = argv[i] + 7;
+    else if (strncmp(argv[i], "--csv=", 6) == 0)
+      csvFile = argv[i] + 6;
+    else if (strncmp(argv[i], "--scenario=", 11) == 0)
+      scenarioName = argv[i] + 11;
+    else if (strncmp(argv[i], "--trace=", 8) == 0)
+      traceFile = argv[i] + 8;
+    else if (strncmp(argv[i], "--record=", 9) == 0)
+      recordFile = argv[i] + 9;
+    else if (strncmp(argv[i], "--fuzz=", 7) == 0) {
+      char* e;
+      fuzzCases = strtod(argv[i] + 7, &e);
+      if (e == argv[i] + 7 || *e || !(fuzzCases >= 1 && fuzzCases < 1e19)) {
+        fprintf(stderr, "Bad argument '%s'. Please specify number of cases in range [1:1e19).\n", argv[i]);
+        return 1;
+      }
+    }
+    else if (strncmp(argv[i], "--seed=", 7) == 0) {
+      char* e;
+      fuzzSeed = strtoull(argv[i] + 7, &e, 0);
+      fuzzSeedSet = true;
+      if (e == argv[i] + 7 || *e) {
+        fprintf(stderr, "Bad argument '%s'.\n", argv[i]);
+        return 1;
+      }
+    }
+    else if (strncmp(argv[i], "--perf-raw=", 11) == 0) {
+      const char* p = argv[i] + 11;
+      while (*p && nPerfRaw < PerfCounters::MAX_RAW) {
+        char* e;
+        perfRaw[nPerfRaw++] = strtoull(p, &e, 0);
+        p = *e == ',' ? e + 1 : e;
+        if (e == p && *p) {
+          fprintf(stderr, "Bad argument '%s'.\n", argv[i]);
+          return 1;
+        }
+      }
+    }
+    else
+      argv[nPos++] = argv[i];
+  }
+  argz = nPos;
+
+  if (fuzzCases > 0) {
+    int nThreads = 0;
+    if (argz >= 2) {
+      char* endp;
+      nThreads = strtol(argv[1], &endp, 0);
+      if (endp == argv[1] || nThreads < 0 || nThreads > 1024) {
+        fprintf(stderr, "Bad argument nThreads='%s'. Please specify number in range [0:1024].\n", argv[1]);
+        return 1;
+      }
+    }
+    if (!fuzzSeedSet)
+      fuzzSeed = (uint64_t(std::random_device()()) << 32) ^ std::random_device()()
+               ^ uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+    InitPow10Table();
+    InitFixedTables();
+    return fuzz_test(uint64_t(fuzzCases), fuzzSeed, nThreads) ? 0 : 1;
+  }
+
   if (argz < 2)
   {
     fprintf(stderr,
       "divpow10_test - test speed and correctness of DivideDecimal68ByPowerOf10() routine.\n"
       "Usage:\n"
-      "divpow10_test nInps [nIter]\n"
+      "divpow10_test [--scenario=name] [--trace=file] [--record=file] [--json=file] [--csv=file] [--perf-raw=code[,code...]]\n"
+      "              nInps [nIter [variant [nThreads]]]\n"
+      "divpow10_test --fuzz=nCases [--seed=seed] [nThreads]\n"
       "where\n"
-      " nInps - # elements in test vector\n"
-      " nIter - number of iterations. Default=17\n"
+      " nInps    - # elements in test vector\n"
+      " nIter    - number of iterations. Default=17\n"
+      " variant  - auto, generic, branchless, srcshift, adx, opt or all. Default=auto\n"
+      "            all - run the tests with auto, then time every variant and the reference on the same inputs\n"
+      " nThreads - when specified, also run throughput and latency loops on up to nThreads pinned threads,\n"
+      "            on separate physical cores and on SMT siblings. Default=0\n"
+      " --scenario    - input distribution: random, correction, ties, small, currency or all. Default=random\n"
+      " --trace       - replay up to nInps calls from trace file, written by DivideDecimal68ByPowerOf10_Traced\n"
+      " --record      - pass generated inputs through DivideDecimal68ByPowerOf10_Traced, recording them to file\n"
+      " --json, --csv - write median, min and spread of the tested variant (every variant with all) and scale range to file\n"
+      " --perf-raw    - up to 4 model-specific perf event codes, e.g. uops dispatched per port,\n"
+      "                 counted together with cycles, instructions and branch mispredictions\n"
+      " --fuzz        - compare every variant, array, lane, template and rounding API against the fast reference on nCases random and edge-biased inputs,\n"
+      "                 on nThreads pinned threads (default - all logical CPUs), stop on the first mismatch\n"
+      " --seed        - seed of --fuzz, default is random. Case k of a run is reproduced by --fuzz=1 --seed=seed+k\n"
       );
     return 1;
   }
@@ -54,6 +239,45 @@ int main(int argz, char**argv)
     }
   }
 
+  const char* variant = argz >= 4 ? argv[3] : "auto";
+  const bool all_variants = strcmp(variant, "all") == 0;
+  divide_fn = 0;
+  for (unsigned vi = 0; vi < sizeof(variants_tab)/sizeof(variants_tab[0]); ++vi) {
+    if (strcmp(variants_tab[vi].name, all_variants ? "auto" : variant) == 0 && variants_tab[vi].divmod) {
+      divide_fn = variants_tab[vi].fn;
+      divmod_fn = variants_tab[vi].divmod;
+      variant_name = variants_tab[vi].name;
+    }
+  }
+  if (!divide_fn) {
+    fprintf(stderr, "Bad argument variant='%s'.\n", variant);
+    return 1;
+  }
+  int nThreads = 0;
+  if (argz >= 5) {
+    nThreads = strtol(argv[4], &endp, 0);
+    if (endp == argv[4] || nThreads < 0 || nThreads > 1024) {
+      fprintf(stderr, "Bad argument nThreads='%s'. Please specify number in range [0:1024].\n", argv[4]);
+      return 1;
+    }
+  }
+
+  const unsigned ADX_FEATURES = DIVPOW10_CPU_BMI2 | DIVPOW10_CPU_ADX;
+  if (divide_fn == DivideDecimal68ByPowerOf10_adx && (DivPow10_CpuFeatures() & ADX_FEATURES) != ADX_FEATURES) {
+    fprintf(stderr, "Variant '%s' is not supported by this CPU.\n", variant);
+    return 1;
+  }
+
+  if (traceFile)
+    scenarioName = "trace";
+  bool scenarioOk = strcmp(scenarioName, "all") == 0;
+  for (unsigned si = 0; si < sizeof(scenario_tab)/sizeof(scenario_tab[0]); ++si)
+    scenarioOk |= strcmp(scenarioName, scenario_tab[si].name) == 0 && (scenario_tab[si].id == SCEN_TRACE) == (traceFile != 0);
+  if (!scenarioOk) {
+    fprintf(stderr, "Bad argument scenario='%s'.\n", scenarioName);
+    return 1;
+  }
+
   if (nInps < 1 || nInps > 1e8) {
     fprintf(stderr, "Bad argument nInps='%s'. Please specify number in range [1:100000000].\n", argv[1]);
     return 1;
@@ -67,11 +291,33 @@ int main(int argz, char**argv)
   nInps = (nInps + 1) & -2; // use even number of inputs
 
   InitPow10Table();
+  InitFixedTables();
+  printf("Variant: %s (auto=branchless)\n", variant);
+  if (perf.Open(perfRaw, nPerfRaw))
+    printf("Perf counters: cycles, instructions, branch-misses%s\n", nPerfRaw ? " and raw events" : "");
+  else
+    printf("Perf counters: not available (%s)\n", perf.Error());
+
+  std::vector<mp_uint256_t> traceInp;
+  std::vector<div_rem_t>    traceOut;
+  std::vector<unsigned>     traceExp;
+  if (traceFile) {
+    if (!load_trace(traceFile, traceInp, traceExp, traceOut, nInps))
+      return 1;
+    nInps = int(traceInp.size());
+    printf("Trace: %d calls from %s\n", nInps, traceFile);
+  }
+  if (recordFile && !DivPow10_TraceOpen(recordFile)) {
+    perror(recordFile);
+    return 1;
+  }
 
   std::vector<mp_uint256_t> inpv(nInps);
   std::vector<div_rem_t>    outv(nInps);
   std::vector<unsigned>     expv(nInps);
 
+  std::vector<bench_result_t> results;
+
   std::mt19937_64 rndGen;
   std::uniform_int_distribution<uint64_t> rndDistr(0, uint64_t(-1));
   auto rndFunc = std::bind ( rndDistr, std::ref(rndGen) );
@@ -83,155 +329,906 @@ int main(int argz, char**argv)
     {20, 27},
     {28, 34},
   };
-  for (unsigned ri = 0; ri < sizeof(n_ranges)/sizeof(n_ranges[0]); ++ri) {
-    unsigned r0 = n_ranges[ri][0];
-    unsigned rl = n_ranges[ri][1]-r0+1;
-    const uint64_t MSK32 = uint64_t(-1) >> (64-32);
-    for (int i = 0; i < nInps; ++i) {
-      uint64_t rndw[5];
-      for (int k = 0; k < 5; ++k)
-        rndw[k] = rndFunc();
-      unsigned n = (((rndw[0] & MSK32)*rl) >> 32) + r0;
-      mp_uint128_t xx; // result of division
-      if (i % 2 == 1) { // distribution with log factor (biased by 8) on range [0:2**112-9]
-        // use 44 random bits to generate log-distributed interval
-        int64_t ex0 = (rndw[1] >> 20)*109 >> 12; // ex in range [0:119*2**32-1]
-        double d_xx0 = floor(exp2((ex0+0)*(1.0/(uint64_t(1) << 32)))*8.0-8.0); // range [0:2**112-9]
-        double d_xx1 = floor(exp2((ex0+1)*(1.0/(uint64_t(1) << 32)))*8.0-8.0);
-        xx = double2uint128(d_xx0);
-        double dULP = d_xx1 - d_xx0;
-        if (dULP > 0) // use 84 remaining random bits to chose random point on interval [d_xx0:d_xx1)
-          xx += mulu(double2uint128(dULP), mp_uint128_t(rndw[1] << 44, rndw[2]));
-      } else { // uniform distribution on range [0:10**34-1]
-        xx = mulu(pow10_tab[34], mp_uint128_t(&rndw[1]));
-      }
-      mp_uint128_t rx = mulu(pow10_tab[n],  mp_uint128_t(&rndw[3])); // remainder of division
-
-      // store inputs for the tests
-      outv[i].div = xx;
-      outv[i].rem = rx;
-      expv[i] = n;
-      inpv[i] = add(mulx(pow10_tab[n], outv[i].div), outv[i].rem);
-    }
-
-    #if REPORT_UNDERFLOWS
-    if (ri==0) {
-      unsigned uu_cnt[35][12] = {{0}};
-      for (int i = 0; i < nInps; ++i) {
-        unsigned n = expv[i];
-        mp_uint128_t offs = uint64_t(0);
-        if (n > 0) {
-          const double LOG2_10  = 3.3219280948873623478703194294894;
-          unsigned re = floor(LOG2_10*n-1); // floor(log2(10**n/2))
-          // generate offset exponentially distributed on range [2..2**re-1]
-          // use 57 random bits to generate log-distributed interval
-          int64_t ex0 = (rndFunc() >> 7)*(re-1) >> 25; // ex in range [0:(re-1)*2**32-1]
-          double d_xx0 = floor(exp2((ex0+0)*(1.0/(uint64_t(1) << 32)))*2.0); // range [2..2**re-1]
-          double d_xx1 = floor(exp2((ex0+1)*(1.0/(uint64_t(1) << 32)))*2.0);
-          offs = double2uint128(d_xx0);
+  for (unsigned si = 0; si < sizeof(scenario_tab)/sizeof(scenario_tab[0]); ++si) {
+    const int scenario = scenario_tab[si].id;
+    if (strcmp(scenarioName, "all") != 0 ? strcmp(scenarioName, scenario_tab[si].name) != 0 : scenario == SCEN_TRACE)
+      continue;
+    printf("Scenario: %s - %s\n", scenario_tab[si].name, scenario_tab[si].descr);
+    for (unsigned ri = 0; ri < sizeof(n_ranges)/sizeof(n_ranges[0]); ++ri) {
+      if ((scenario == SCEN_CURRENCY || scenario == SCEN_TRACE) && ri > 0)
+        break; // scale is taken from the histogram or from the trace, not from n_ranges
+      unsigned r0 = n_ranges[ri][0];
+      unsigned rl = n_ranges[ri][1]-r0+1;
+      const uint64_t MSK32 = uint64_t(-1) >> (64-32);
+      for (int i = 0; i < nInps && scenario != SCEN_TRACE; ++i) {
+        uint64_t rndw[5];
+        for (int k = 0; k < 5; ++k)
+          rndw[k] = rndFunc();
+        unsigned n = (((rndw[0] & MSK32)*rl) >> 32) + r0;
+        if (scenario == SCEN_CURRENCY)
+          n = currency_n_tab[(((rndw[0] & MSK32)*(sizeof(currency_n_tab)/sizeof(currency_n_tab[0]))) >> 32)];
+        mp_uint128_t xx; // result of division
+        if (scenario == SCEN_SMALL) { // up to 6 digits, number of digits is uniform
+          xx = mulu(pow10_tab[(rndw[1] >> 32) % 7], mp_uint128_t(&rndw[1]));
+        } else if (i % 2 == 1) { // distribution with log factor (biased by 8) on range [0:2**112-9]
+          // use 44 random bits to generate log-distributed interval
+          int64_t ex0 = (rndw[1] >> 20)*109 >> 12; // ex in range [0:119*2**32-1]
+          double d_xx0 = floor(exp2((ex0+0)*(1.0/(uint64_t(1) << 32)))*8.0-8.0); // range [0:2**112-9]
+          double d_xx1 = floor(exp2((ex0+1)*(1.0/(uint64_t(1) << 32)))*8.0-8.0);
+          xx = double2uint128(d_xx0);
           double dULP = d_xx1 - d_xx0;
-          if (dULP > 0) // use 128 random bits to chose random point on interval [d_xx0:d_xx1)
-            offs += mulu(double2uint128(dULP), mp_uint128_t(rndFunc(), rndFunc()));
+          if (dULP > 0) // use 84 remaining random bits to chose random point on interval [d_xx0:d_xx1)
+            xx += mulu(double2uint128(dULP), mp_uint128_t(rndw[1] << 44, rndw[2]));
+        } else { // uniform distribution on range [0:10**34-1]
+          xx = mulu(pow10_tab[34], mp_uint128_t(&rndw[1]));
         }
-        mp_uint256_t src[11];
-        src[0]  = mulx(pow10_tab[n], outv[i].div);
-        src[5]  = add(src[0], pow10_tab[n].half());
-        src[1]  = add(src[0], 1);
-        src[2]  = add(src[0], offs);
-        src[3]  = sub(src[5], offs);
-        src[4]  = sub(src[5], 1);
-        src[6]  = add(src[5], 1);
-        src[7]  = add(src[5], offs);
-        src[8]  = add(src[3], pow10_tab[n].half());
-        src[9]  = add(src[4], pow10_tab[n].half());
-        src[10] = inpv[i];
-        for (int k = 0; k < 11; ++k) {
-          uint64_t dummy[2];
-          DivideDecimal68ByPowerOf10(dummy, src[k].w, n);
-          uu_cnt[n][k+1] += gl_underflow;
+        mp_uint128_t rx = mulu(pow10_tab[n],  mp_uint128_t(&rndw[3])); // remainder of division
+        if (n > 0 && (scenario == SCEN_TIES || (scenario == SCEN_CORRECTION && i % 2 == 0))) {
+          rx = pow10_tab[n].half();
+          // src at an exact multiple of 10**n/2, remainder 0 or exactly half. Reciprocal underestimates
+          // the quotient of an exact multiple, so the fraction is close to 1 and the quotient is corrected
+          if (scenario == SCEN_CORRECTION && i % 4 == 0)
+            rx = uint64_t(0);
         }
-        uu_cnt[n][0] += 1;
+
+        // store inputs for the tests
+        outv[i].div = xx;
+        outv[i].rem = rx;
+        expv[i] = n;
+        inpv[i] = add(mulx(pow10_tab[n], outv[i].div), outv[i].rem);
       }
-      for (int i = 0; i < 35; ++i) {
-        printf("%2d", i);
-        for (int k = 0; k < 12; ++k)
-          printf(" %6u", uu_cnt[i][k]);
-        printf("\n");
+      if (scenario == SCEN_TRACE) {
+        inpv = traceInp;
+        expv = traceExp;
+        outv = traceOut;
+      } else if (recordFile) {
+        for (int i = 0; i < nInps; ++i) {
+          uint64_t y[2];
+          DivideDecimal68ByPowerOf10_Traced(y, inpv[i].w, expv[i]);
+        }
       }
-    }
-    #endif
 
-    if (!result_test(inpv.data(), expv.data(), outv.data(), nInps))
-      return 1;
-    time_test(inpv.data(), expv.data(), nInps, nIter);
+      #if REPORT_UNDERFLOWS
+      if (ri==0) {
+        printf("Underflows, scenario %s:\n", scenario_tab[si].name);
+        unsigned uu_cnt[35][12] = {{0}};
+        for (int i = 0; i < nInps; ++i) {
+          unsigned n = expv[i];
+          mp_uint128_t offs = uint64_t(0);
+          if (n > 0) {
+            const double LOG2_10  = 3.3219280948873623478703194294894;
+            unsigned re = floor(LOG2_10*n-1); // floor(log2(10**n/2))
+            // generate offset exponentially distributed on range [2..2**re-1]
+            // use 57 random bits to generate log-distributed interval
+            int64_t ex0 = (rndFunc() >> 7)*(re-1) >> 25; // ex in range [0:(re-1)*2**32-1]
+            double d_xx0 = floor(exp2((ex0+0)*(1.0/(uint64_t(1) << 32)))*2.0); // range [2..2**re-1]
+            double d_xx1 = floor(exp2((ex0+1)*(1.0/(uint64_t(1) << 32)))*2.0);
+            offs = double2uint128(d_xx0);
+            double dULP = d_xx1 - d_xx0;
+            if (dULP > 0) // use 128 random bits to chose random point on interval [d_xx0:d_xx1)
+              offs += mulu(double2uint128(dULP), mp_uint128_t(rndFunc(), rndFunc()));
+          }
+          mp_uint256_t src[11];
+          src[0]  = mulx(pow10_tab[n], outv[i].div);
+          src[5]  = add(src[0], pow10_tab[n].half());
+          src[1]  = add(src[0], 1);
+          src[2]  = add(src[0], offs);
+          src[3]  = sub(src[5], offs);
+          src[4]  = sub(src[5], 1);
+          src[6]  = add(src[5], 1);
+          src[7]  = add(src[5], offs);
+          src[8]  = add(src[3], pow10_tab[n].half());
+          src[9]  = add(src[4], pow10_tab[n].half());
+          src[10] = inpv[i];
+          for (int k = 0; k < 11; ++k) {
+            uint64_t dummy[2];
+            divide_fn(dummy, src[k].w, n);
+            uu_cnt[n][k+1] += gl_underflow;
+          }
+          uu_cnt[n][0] += 1;
+        }
+        for (int i = 0; i < 35; ++i) {
+          printf("%2d", i);
+          for (int k = 0; k < 12; ++k)
+            printf(" %6u", uu_cnt[i][k]);
+          printf("\n");
+        }
+      }
+      #endif
+
+      if (!result_test(inpv.data(), expv.data(), outv.data(), nInps))
+        return 1;
+      if (!divmod_test(inpv.data(), expv.data(), outv.data(), nInps))
+        return 1;
+      if (!round_test(inpv.data(), expv.data(), outv.data(), nInps))
+        return 1;
+      if (!batch_test(inpv.data(), expv.data(), outv.data(), nInps))
+        return 1;
+      if (!lanes_test(inpv.data(), expv.data(), outv.data(), nInps))
+        return 1;
+      if (!column_test(inpv.data(), expv.data(), outv.data(), nInps))
+        return 1;
+      if (!fixed_test(inpv.data(), expv.data(), outv.data(), nInps))
+        return 1;
+      if (!wide_test(inpv.data(), expv.data(), outv.data(), nInps))
+        return 1;
+      time_test(all_variants ? 0 : &results, scenario_tab[si].name, inpv.data(), expv.data(), nInps, nIter);
+      cold_time_test(inpv.data(), expv.data(), nInps, nIter);
+      if (ri == 0 && nThreads > 0)
+        mt_time_test(inpv.data(), expv.data(), nInps, nIter, nThreads);
+      round_time_test(inpv.data(), expv.data(), nInps, nIter);
+      lanes_time_test(inpv.data(), expv.data(), nInps, nIter);
+      bucket_time_test(inpv.data(), expv.data(), nInps, nIter);
+      column_time_test(inpv.data(), expv.data(), nInps, nIter);
+      fixed_time_test(inpv.data(), expv.data(), nInps, nIter);
+      if (all_variants && !compare_variants(results, scenario_tab[si].name, inpv.data(), expv.data(), outv.data(), nInps, nIter))
+        return 1;
+    }
   }
+  if (all_variants)
+    per_n_time_test(inpv.data(), outv.data(), nInps, nIter);
+  if (recordFile)
+    DivPow10_TraceClose();
+  if (jsonFile && !write_results(jsonFile, true, results, nInps, nIter))
+    return 1;
+  if (csvFile && !write_results(csvFile, false, results, nInps, nIter))
+    return 1;
+
+  if (!dec32_test(nInps, nIter))
+    return 1;
+  if (!dec144_test(nInps, nIter))
+    return 1;
+  if (!normalize_test(nInps, nIter))
+    return 1;
 
   return 0;
 }
 
 volatile uint64_t vo_zero;
-static void time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter)
+
+// spin_barrier - all threads start every timed loop together
+struct spin_barrier {
+  std::atomic<int> cnt;
+  std::atomic<int> gen;
+  int n;
+  explicit spin_barrier(int n_) : cnt(0), gen(0), n(n_) {}
+  void wait() {
+    const int g = gen.load();
+    if (cnt.fetch_add(1) + 1 == n) {
+      cnt.store(0);
+      gen.fetch_add(1);
+    } else {
+      while (gen.load() == g)
+        std::this_thread::yield();
+    }
+  }
+};
+
+// time_loops - run timing loop nIter times, store time of every iteration in tmVec[], ns
+// call(i, dn) makes the calls for inputs i to i+step-1, with dn added to their exponents, and returns
+// their results folded into one word. In latency mode (LAT=true) dn of the next step depends on the results
+// of the previous one, that makes a dependency chain through all calls, in throughput mode dn=0 and calls are independent.
+// pc, when not 0, counts events of all iterations, barrier, when not 0, starts every iteration on all threads together.
+template <bool LAT, class Call>
+static void time_loops(std::vector<int64_t>& tmVec, int nInps, int step, Call call, PerfCounters* pc = 0, spin_barrier* barrier = 0)
 {
-  std::vector<int64_t> tmVec(nIter);
-  // Throughput test
   uint64_t dummy = 0;
-  for (int it = 0; it < nIter; ++it) {
+  if (pc)
+    pc->Reset();
+  for (size_t it = 0; it < tmVec.size(); ++it) {
+    uint64_t zero = vo_zero;
+    unsigned dummy_n = 0;
+    if (barrier)
+      barrier->wait();
+    if (pc)
+      pc->Start();
     std::chrono::steady_clock::time_point hres_t0 = std::chrono::steady_clock::now();
-    for (int i = 0; i < nInps; ++i) {
-      uint64_t y[2];
-      int r = DivideDecimal68ByPowerOf10(y, inpv[i].w, expv[i]);
-      dummy ^= y[0];
-      dummy ^= y[1];
-      dummy ^= r;
+    for (int i = 0; i + step <= nInps; i += step) {
+      dummy ^= call(i, dummy_n);
+      if (LAT)
+        dummy_n = ((dummy & zero) != 0);
     }
     std::chrono::steady_clock::time_point hres_t1 = std::chrono::steady_clock::now();
-    tmVec[it] = std::chrono::duration_cast<std::chrono::microseconds>(hres_t1 - hres_t0).count();
+    if (pc)
+      pc->Stop();
+    tmVec[it] = std::chrono::duration_cast<std::chrono::nanoseconds>(hres_t1 - hres_t0).count();
   }
+  if (dummy==42)
+    printf("Blue moon\n");
+}
+
+// time_divide - time_loops over fn(result, inpv[i], expv[i]), one call per step
+template <bool LAT>
+static void time_divide(std::vector<int64_t>& tmVec, DivideDecimal68ByPowerOf10_fn fn, const mp_uint256_t* inpv, const unsigned* expv, int nInps,
+  PerfCounters* pc = 0, spin_barrier* barrier = 0)
+{
+  time_loops<LAT>(tmVec, nInps, 1, [=](int i, unsigned dn) {
+    uint64_t y[2];
+    int r = fn(y, inpv[i].w, expv[i]+dn);
+    return y[0] ^ y[1] ^ uint64_t(r);
+  }, pc, barrier);
+}
+
+// median_ns - median of times of iterations, ns
+static int64_t median_ns(std::vector<int64_t>& tmVec)
+{
+  const int nIter = int(tmVec.size());
   std::nth_element(tmVec.begin(), tmVec.begin()+(nIter/2), tmVec.end());
-  int64_t tmMed_t = tmVec[nIter/2];
+  return tmVec[nIter/2];
+}
+
+// add_result - append median, min and max of times of iterations and events per call to results[], for --json and --csv
+static void add_result(std::vector<bench_result_t>& results, const char* scenario, const char* variant, unsigned n_min, unsigned n_max,
+  const char* metric, const std::vector<int64_t>& tmVec, int nInps, const PerfCounters& pc)
+{
+  std::vector<int64_t> tm(tmVec);
+  bench_result_t res;
+  for (int e = 0; e < PerfCounters::MAX_EVENTS; ++e)
+    res.perf[e] = pc.PerCall(e, double(tm.size())*nInps);
+  res.scenario  = scenario;
+  res.variant   = variant;
+  res.n_min     = n_min;
+  res.n_max     = n_max;
+  res.metric    = metric;
+  res.min_ns    = double(*std::min_element(tm.begin(), tm.end())) / nInps;
+  res.max_ns    = double(*std::max_element(tm.begin(), tm.end())) / nInps;
+  res.median_ns = double(median_ns(tm)) / nInps;
+  results.push_back(res);
+}
+
+// time_test - throughput and latency of the implementation under test, throughput of DivMod and Batch.
+// Throughput and latency are appended to results[], unless every variant is compared by compare_variants()
+static void time_test(std::vector<bench_result_t>* results, const char* scenario, const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter)
+{
+  int64_t ssum = 0;
+  unsigned s_min = expv[0];
+  unsigned s_max = expv[0];
+  for (int i = 0; i < nInps; ++i) {
+    unsigned s = expv[i];
+    ssum += s;
+    if (s_min > s) s_min = s;
+    if (s_max < s) s_max = s;
+  }
+
+  std::vector<int64_t> tmVec(nIter);
+  // Throughput test
+  time_divide<false>(tmVec, divide_fn, inpv, expv, nInps, &perf);
+  if (results)
+    add_result(*results, scenario, variant_name, s_min, s_max, "rThr", tmVec, nInps, perf);
+  int64_t tmMed_t = median_ns(tmVec);
+  print_perf("Perf rThr:", perf, double(nIter)*nInps);
+
+  // DivMod throughput test
+  time_loops<false>(tmVec, nInps, 1, [=](int i, unsigned) {
+    uint64_t y[2], rem[2];
+    int r = divmod_fn(y, rem, inpv[i].w, expv[i]);
+    return y[0] ^ y[1] ^ rem[0] ^ rem[1] ^ uint64_t(r);
+  });
+  int64_t tmMed_d = median_ns(tmVec);
+
+  // Batch throughput test
+  std::vector<mp_uint128_t> resv(nInps);
+  std::vector<int>          retv(nInps);
+  time_loops<false>(tmVec, nInps, nInps, [&](int, unsigned) {
+    DivideDecimal68ByPowerOf10_Batch(&resv[0].w, retv.data(), &inpv[0].w, expv, nInps);
+    return resv[0].w[0];
+  });
+  int64_t tmMed_b = median_ns(tmVec);
 
   // Latency test
+  time_divide<true>(tmVec, divide_fn, inpv, expv, nInps, &perf);
+  if (results)
+    add_result(*results, scenario, variant_name, s_min, s_max, "Lat", tmVec, nInps, perf);
+  int64_t tmMed_l = median_ns(tmVec);
+  print_perf("Perf Lat: ", perf, double(nIter)*nInps);
+
+  printf("rThr= %5.2f ns/call. %8lld usec total. dmThr= %5.2f ns/call. bThr= %5.2f ns/elem. Lat= %5.2f ns/call. %8lld usec total. Scale= %2u to %2u, average %5.2f.\n"
+    , double(tmMed_t)/nInps
+    , (long long)(tmMed_t/1000)
+    , double(tmMed_d)/nInps
+    , double(tmMed_b)/nInps
+    , double(tmMed_l)/nInps
+    , (long long)(tmMed_l/1000)
+    , s_min, s_max
+    , double(ssum)/nInps
+    );
+}
+
+// load_trace - memory-map trace file, written by DivideDecimal68ByPowerOf10_Traced, and decode up to maxRecords calls
+// Expected results are calculated by DivideDecimal68ByPowerOf10_fastref. Calls with n > 34 or quotient >= 10**34
+// are out of the range that is tested by the rest of the suite, they are counted and skipped. Number of decoded calls is rounded down to even.
+static bool load_trace(const char* fname, std::vector<mp_uint256_t>& inpv, std::vector<unsigned>& expv, std::vector<div_rem_t>& outv, int maxRecords)
+{
+  const uint8_t* data = 0;
+  size_t size = 0;
+#ifdef _WIN32
+  HANDLE hFile = CreateFileA(fname, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+  HANDLE hMap  = 0;
+  LARGE_INTEGER fsize;
+  if (hFile != INVALID_HANDLE_VALUE && GetFileSizeEx(hFile, &fsize) && fsize.QuadPart > 0) {
+    size = size_t(fsize.QuadPart);
+    hMap = CreateFileMappingA(hFile, 0, PAGE_READONLY, 0, 0, 0);
+    if (hMap)
+      data = (const uint8_t*)MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+  }
+#else
+  int fd = open(fname, O_RDONLY);
+  struct stat st;
+  if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0) {
+    size = size_t(st.st_size);
+    void* p = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED) {
+      data = (const uint8_t*)p;
+#ifdef MADV_SEQUENTIAL
+      madvise(p, size, MADV_SEQUENTIAL);
+#endif
+    }
+  }
+#endif
+
+  bool ok = false;
+  if (!data) {
+    fprintf(stderr, "Can't map trace file '%s'.\n", fname);
+  } else if (size < DIVPOW10_TRACE_HDR_SIZE || memcmp(data, DIVPOW10_TRACE_MAGIC, 8) != 0 || data[8] != DIVPOW10_TRACE_REC_SIZE) {
+    fprintf(stderr, "'%s' is not a trace file.\n", fname);
+  } else {
+    const size_t nRec = (size - DIVPOW10_TRACE_HDR_SIZE) / DIVPOW10_TRACE_REC_SIZE;
+    size_t nSkipped = 0;
+    inpv.clear();
+    expv.clear();
+    outv.clear();
+    for (size_t k = 0; k < nRec && inpv.size() < size_t(maxRecords); ++k) {
+      mp_uint256_t x;
+      memcpy(x.w, data + DIVPOW10_TRACE_HDR_SIZE + k*DIVPOW10_TRACE_REC_SIZE, sizeof(x.w));
+      const unsigned n = unsigned(x.w[3] >> 56);
+      x.w[3] &= (uint64_t(1) << 56) - 1;
+      uint64_t q[2];
+      if (n > 34) {
+        ++nSkipped;
+        continue;
+      }
+      DivideDecimal68ByPowerOf10_fastref(q, x.w, n);
+      const mp_uint256_t qx = mulx(pow10_tab[n], mp_uint128_t(q));
+      const mp_uint256_t r  = sub(x, qx);
+      if (cmp(mp_uint128_t(q), pow10_tab[34]) >= 0 || (r.w[2] | r.w[3]) != 0) { // quotient >= 10**34, or >= 2**128 and truncated
+        ++nSkipped;
+        continue;
+      }
+      div_rem_t out;
+      out.div = mp_uint128_t(q);
+      out.rem = mp_uint128_t(r.w[0], r.w[1]);
+      inpv.push_back(x);
+      expv.push_back(n);
+      outv.push_back(out);
+    }
+    const size_t nEven = inpv.size() & ~size_t(1);
+    inpv.resize(nEven);
+    expv.resize(nEven);
+    outv.resize(nEven);
+    if (nSkipped)
+      printf("Trace: %zu calls out of range skipped\n", nSkipped);
+    ok = nEven > 0;
+    if (!ok)
+      fprintf(stderr, "Trace file '%s' has no usable calls.\n", fname);
+  }
+
+#ifdef _WIN32
+  if (data)
+    UnmapViewOfFile(data);
+  if (hMap)
+    CloseHandle(hMap);
+  if (hFile != INVALID_HANDLE_VALUE)
+    CloseHandle(hFile);
+#else
+  if (data)
+    munmap((void*)data, size);
+  if (fd >= 0)
+    close(fd);
+#endif
+  return ok;
+}
+
+// print_perf - print events per call, when counters are available
+static void print_perf(const char* prefix, const PerfCounters& pc, double nCalls)
+{
+  if (!pc.Available())
+    return;
+  printf("%s cyc= %6.2f ins= %6.2f brmis= %6.4f /call."
+    , prefix
+    , pc.PerCall(PerfCounters::CYCLES, nCalls)
+    , pc.PerCall(PerfCounters::INSTRUCTIONS, nCalls)
+    , pc.PerCall(PerfCounters::BRANCH_MISSES, nCalls)
+    );
+  for (int e = PerfCounters::N_FIXED; e < pc.NumEvents(); ++e)
+    printf(" raw%d(0x%llx)= %6.3f", e - PerfCounters::N_FIXED, (unsigned long long)perfRaw[e - PerfCounters::N_FIXED], pc.PerCall(e, nCalls));
+  printf("\n");
+}
+
+// cold_time_test - measure DivideDecimal68ByPowerOf10 when its tables are out of L1D
+// Calls are made in small bursts, between bursts a buffer larger than L1D is walked, that evicts the tables.
+// Inputs of the burst are touched after eviction, so only table misses are measured.
+// Only the burst itself is timed, in ns, and times of all bursts are summed. The same sum without calls,
+// i.e. the cost of reading the clock, is measured separately and subtracted.
+// Non-positive results, possible when the difference is below the noise, are reported as n/a.
+static void cold_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter)
+{
+  enum { EVICT_BYTES = 128*1024, LINE = 64, MAX_BURSTS = 4096 };
+  static const int burstTab[] = { 1, 8 };
+  std::vector<uint64_t> evictBuf(EVICT_BYTES/sizeof(uint64_t), 1);
+  std::vector<int64_t> tmVec(nIter);
+  double nsPerCall[2];
+  uint64_t dummy = 0;
+  for (int bi = 0; bi < 2; ++bi) {
+    const int burst = burstTab[bi];
+    const int nBursts = std::min(nInps / burst, int(MAX_BURSTS));
+    int64_t tmMed[2];
+    for (int withCalls = 0; withCalls < 2; ++withCalls) {
+      for (int it = 0; it < nIter; ++it) {
+        int64_t tmSum = 0;
+        for (int k = 0; k < nBursts; ++k) {
+          for (size_t j = 0; j < evictBuf.size(); j += LINE/sizeof(uint64_t))
+            dummy += evictBuf[j];
+          const mp_uint256_t* inp = &inpv[k*burst];
+          for (int i = 0; i < burst; ++i)
+            dummy ^= inp[i].w[0] ^ inp[i].w[3];
+          std::chrono::steady_clock::time_point hres_t0 = std::chrono::steady_clock::now();
+          if (withCalls) {
+            for (int i = 0; i < burst; ++i) {
+              uint64_t y[2];
+              int r = divide_fn(y, inp[i].w, expv[k*burst+i]);
+              dummy ^= y[0];
+              dummy ^= y[1];
+              dummy ^= r;
+            }
+          }
+          std::chrono::steady_clock::time_point hres_t1 = std::chrono::steady_clock::now();
+          tmSum += std::chrono::duration_cast<std::chrono::nanoseconds>(hres_t1 - hres_t0).count();
+        }
+        tmVec[it] = tmSum;
+      }
+      std::nth_element(tmVec.begin(), tmVec.begin()+(nIter/2), tmVec.end());
+      tmMed[withCalls] = tmVec[nIter/2];
+    }
+    nsPerCall[bi] = (tmMed[1] - tmMed[0])/(double(nBursts)*burst);
+  }
+
+  printf("Cold:");
+  for (int bi = 0; bi < 2; ++bi) {
+    if (nsPerCall[bi] > 0)
+      printf(" burst=%d %5.2f ns/call.", burstTab[bi], nsPerCall[bi]);
+    else
+      printf(" burst=%d   n/a ns/call.", burstTab[bi]);
+  }
+  printf(" %d KB evicted between bursts.\n", int(EVICT_BYTES/1024));
+
+  if (dummy==42)
+    printf("Blue moon\n");
+}
+
+// physical_cores - logical CPUs available to the process, grouped by physical core
+static std::vector<std::vector<int>> physical_cores()
+{
+  std::vector<std::vector<int>> cores;
+#if defined(__linux__)
+  cpu_set_t avail;
+  CPU_ZERO(&avail);
+  if (sched_getaffinity(0, sizeof(avail), &avail) != 0)
+    return cores;
+  std::map<std::string, std::vector<int>> byCore; // key: thread_siblings_list, the same for all siblings
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (!CPU_ISSET(cpu, &avail))
+      continue;
+    char path[128], buf[256] = "";
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+    if (FILE* fp = fopen(path, "r")) {
+      if (!fgets(buf, sizeof(buf), fp))
+        buf[0] = 0;
+      fclose(fp);
+    }
+    if (buf[0] == 0)
+      snprintf(buf, sizeof(buf), "%d", cpu); // unknown topology - every CPU is a core
+    byCore[buf].push_back(cpu);
+  }
+  for (auto& c : byCore)
+    cores.push_back(c.second);
+#elif defined(_WIN32)
+  DWORD len = 0;
+  GetLogicalProcessorInformation(0, &len);
+  std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(len / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+  if (!GetLogicalProcessorInformation(info.data(), &len))
+    return cores;
+  for (const auto& e : info) {
+    if (e.Relationship != RelationProcessorCore)
+      continue;
+    std::vector<int> core;
+    for (int cpu = 0; cpu < int(sizeof(ULONG_PTR)*8); ++cpu)
+      if (e.ProcessorMask & (ULONG_PTR(1) << cpu))
+        core.push_back(cpu);
+    cores.push_back(core);
+  }
+#else
+  for (int cpu = 0; cpu < int(std::thread::hardware_concurrency()); ++cpu)
+    cores.push_back(std::vector<int>(1, cpu));
+#endif
+  std::sort(cores.begin(), cores.end());
+  return cores;
+}
+
+// pin_current_thread - bind calling thread to logical CPU, silently does nothing where unsupported
+static void pin_current_thread(int cpu)
+{
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32)
+  SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+#else
+  (void)cpu;
+#endif
+}
+
+// mt_run - run throughput and latency loops of time_test() on pinned threads, one thread per entry of cpus[]
+// Every thread works on its own copy of the slice of the inputs
+// tmMed[0]=median throughput ns/call, tmMed[1]=median latency ns/call, averaged over threads
+static void mt_run(double tmMed[2], const std::vector<int>& cpus, const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter)
+{
+  const int nThr = int(cpus.size());
+  const int sliceLen = std::max(nInps / nThr, 1);
+  spin_barrier barrier(nThr);
+  std::vector<double> thrRes(nThr*2);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nThr; ++t) {
+    threads.emplace_back([&, t]() {
+      pin_current_thread(cpus[t]);
+      const int i0 = (t * sliceLen) % std::max(nInps - sliceLen + 1, 1);
+      std::vector<mp_uint256_t> inp(inpv + i0, inpv + i0 + sliceLen);
+      std::vector<unsigned>     exp(expv + i0, expv + i0 + sliceLen);
+      std::vector<int64_t> tmVec(nIter);
+      time_divide<false>(tmVec, divide_fn, inp.data(), exp.data(), sliceLen, 0, &barrier);
+      thrRes[t*2+0] = double(median_ns(tmVec))/sliceLen;
+      time_divide<true>(tmVec, divide_fn, inp.data(), exp.data(), sliceLen, 0, &barrier);
+      thrRes[t*2+1] = double(median_ns(tmVec))/sliceLen;
+    });
+  }
+  for (auto& th : threads)
+    th.join();
+  tmMed[0] = tmMed[1] = 0;
+  for (int t = 0; t < nThr; ++t) {
+    tmMed[0] += thrRes[t*2+0] / nThr;
+    tmMed[1] += thrRes[t*2+1] / nThr;
+  }
+}
+
+// mt_time_test - scaling of DivideDecimal68ByPowerOf10 over physical cores and SMT siblings
+// Runs the loops on up to nThreads threads pinned to separate physical cores, then on pairs of SMT siblings,
+// and reports per-thread ns/call, aggregate Mops/s and slowdown of SMT pairs relative to separate cores
+static void mt_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter, int nThreads)
+{
+  std::vector<std::vector<int>> cores = physical_cores();
+  if (cores.empty()) {
+    printf("MT: CPU topology is not available.\n");
+    return;
+  }
+
+  std::vector<int> sepCpus;  // one logical CPU per physical core
+  std::vector<int> smtCpus;  // both siblings of physical cores
+  for (const auto& c : cores) {
+    if (int(sepCpus.size()) < nThreads)
+      sepCpus.push_back(c[0]);
+    if (c.size() >= 2 && int(smtCpus.size()) + 2 <= nThreads) {
+      smtCpus.push_back(c[0]);
+      smtCpus.push_back(c[1]);
+    }
+  }
+
+  double tm1[2], tmSep[2], tmSmt[2];
+  mt_run(tm1, std::vector<int>(1, sepCpus[0]), inpv, expv, nInps, nIter);
+  mt_run(tmSep, sepCpus, inpv, expv, nInps, nIter);
+  printf("MT %2d thread  on  1 core : rThr= %5.2f ns/call. Lat= %5.2f ns/call. Aggregate %7.1f Mops/s.\n"
+    , 1, tm1[0], tm1[1], 1e3/tm1[0]);
+  printf("MT %2d threads on %2d cores: rThr= %5.2f ns/call. Lat= %5.2f ns/call. Aggregate %7.1f Mops/s. Per-thread slowdown x%4.2f.\n"
+    , int(sepCpus.size()), int(sepCpus.size()), tmSep[0], tmSep[1], sepCpus.size()*1e3/tmSep[0], tmSep[0]/tm1[0]);
+  if (smtCpus.empty()) {
+    printf("MT SMT pairs: no SMT siblings available.\n");
+    return;
+  }
+  mt_run(tmSmt, smtCpus, inpv, expv, nInps, nIter);
+  printf("MT %2d threads on %2d cores: rThr= %5.2f ns/call. Lat= %5.2f ns/call. Aggregate %7.1f Mops/s. SMT slowdown rThr x%4.2f, Lat x%4.2f.\n"
+    , int(smtCpus.size()), int(smtCpus.size()/2), tmSmt[0], tmSmt[1], smtCpus.size()*1e3/tmSmt[0], tmSmt[0]/tmSep[0], tmSmt[1]/tmSep[1]);
+}
+
+// per_n_time_test - throughput of every variant for each fixed n, next to multiplication count of opt variant
+// Quotients are taken from outv[], remainders are uniform, built from low words of inpv[]
+static void per_n_time_test(const mp_uint256_t* inpv, const div_rem_t* outv, int nInps, int nIter)
+{
+  const unsigned ADX_FEATURES = DIVPOW10_CPU_BMI2 | DIVPOW10_CPU_ADX;
+  std::vector<unsigned> vars;
+  printf("Per-n rThr, ns/call:\n   n muls");
+  for (unsigned vi = 0; vi < sizeof(variants_tab)/sizeof(variants_tab[0]); ++vi) {
+    if (!variants_tab[vi].divmod || strcmp(variants_tab[vi].name, "auto") == 0) // references and the alias
+      continue;
+    if (variants_tab[vi].fn == DivideDecimal68ByPowerOf10_adx && (DivPow10_CpuFeatures() & ADX_FEATURES) != ADX_FEATURES)
+      continue;
+    vars.push_back(vi);
+    printf(" %10s", variants_tab[vi].name);
+  }
+  printf("\n");
+
+  std::vector<mp_uint256_t> xv(nInps);
+  std::vector<int64_t> tmVec(nIter);
+  uint64_t dummy = 0;
+  for (unsigned n = 1; n <= 34; ++n) {
+    for (int i = 0; i < nInps; ++i)
+      xv[i] = add(mulx(pow10_tab[n], outv[i].div), mulu(pow10_tab[n], mp_uint128_t(inpv[i].w)));
+    printf("  %2u %4u", n, DivPow10Opt_MulCount(n));
+    for (unsigned vi : vars) {
+      DivideDecimal68ByPowerOf10_fn fn = variants_tab[vi].fn;
+      for (int it = 0; it < nIter; ++it) {
+        std::chrono::steady_clock::time_point hres_t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < nInps; ++i) {
+          uint64_t y[2];
+          int r = fn(y, xv[i].w, n);
+          dummy ^= y[0];
+          dummy ^= y[1];
+          dummy ^= r;
+        }
+        std::chrono::steady_clock::time_point hres_t1 = std::chrono::steady_clock::now();
+        tmVec[it] = std::chrono::duration_cast<std::chrono::nanoseconds>(hres_t1 - hres_t0).count();
+      }
+      std::nth_element(tmVec.begin(), tmVec.begin()+(nIter/2), tmVec.end());
+      printf(" %10.2f", double(tmVec[nIter/2])/nInps);
+    }
+    printf("\n");
+  }
+  if (dummy==42)
+    printf("Blue moon\n");
+}
+
+// compare_variants - check every entry of variants_tab on the same inputs, then time their throughput
+// and latency loops. One line per variant is printed, results are appended to results[]
+static bool compare_variants(std::vector<bench_result_t>& results, const char* scenario, const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps, int nIter)
+{
+  const unsigned n_min = *std::min_element(expv, expv+nInps);
+  const unsigned n_max = *std::max_element(expv, expv+nInps);
+  const DivideDecimal68ByPowerOf10_fn fn_save = divide_fn;
+  const unsigned ADX_FEATURES = DIVPOW10_CPU_BMI2 | DIVPOW10_CPU_ADX;
+  std::vector<int64_t> tmVec(nIter);
+  bool ok = true;
+  printf("Compare scale=%2u to %2u:\n", n_min, n_max);
+  for (unsigned vi = 0; vi < sizeof(variants_tab)/sizeof(variants_tab[0]) && ok; ++vi) {
+    DivideDecimal68ByPowerOf10_fn fn = variants_tab[vi].fn;
+    if (fn == DivideDecimal68ByPowerOf10_adx && (DivPow10_CpuFeatures() & ADX_FEATURES) != ADX_FEATURES)
+      continue;
+    divide_fn = fn;
+    if (!result_test(inpv, expv, outv, nInps)) {
+      fprintf(stderr, "Variant '%s' failed.\n", variants_tab[vi].name);
+      ok = false;
+      break;
+    }
+
+    for (int mode = 0; mode < 2; ++mode) { // 0 - throughput, 1 - latency
+      if (mode == 0)
+        time_divide<false>(tmVec, fn, inpv, expv, nInps, &perf);
+      else
+        time_divide<true>(tmVec, fn, inpv, expv, nInps, &perf);
+      add_result(results, scenario, variants_tab[vi].name, n_min, n_max, mode == 0 ? "rThr" : "Lat", tmVec, nInps, perf);
+    }
+    const bench_result_t* res = &results[results.size() - 2];
+    printf("  %-10s rThr= %7.2f ns/call (min %7.2f, spread %5.1f%%). Lat= %7.2f ns/call (min %7.2f, spread %5.1f%%).\n"
+      , variants_tab[vi].name
+      , res[0].median_ns, res[0].min_ns, (res[0].max_ns - res[0].min_ns)*100/res[0].median_ns
+      , res[1].median_ns, res[1].min_ns, (res[1].max_ns - res[1].min_ns)*100/res[1].median_ns
+      );
+    if (perf.Available()) {
+      printf("  %-10s rThr cyc= %6.2f ins= %6.2f brmis= %6.4f /call. Lat cyc= %6.2f ins= %6.2f brmis= %6.4f /call.\n"
+        , ""
+        , res[0].perf[PerfCounters::CYCLES], res[0].perf[PerfCounters::INSTRUCTIONS], res[0].perf[PerfCounters::BRANCH_MISSES]
+        , res[1].perf[PerfCounters::CYCLES], res[1].perf[PerfCounters::INSTRUCTIONS], res[1].perf[PerfCounters::BRANCH_MISSES]
+        );
+    }
+  }
+  divide_fn = fn_save;
+  return ok;
+}
+
+static const char* const perf_event_names[PerfCounters::MAX_EVENTS] = {
+  "cycles", "instructions", "branch_misses", "raw0", "raw1", "raw2", "raw3" };
+
+// write_results - store results of time_test() or compare_variants() as JSON or CSV
+// spread is (max - min) / median of per-iteration times, perf events are per call, omitted when not available
+static bool write_results(const char* fname, bool json, const std::vector<bench_result_t>& results, int nInps, int nIter)
+{
+  FILE* fp = fopen(fname, "w");
+  if (!fp) {
+    perror(fname);
+    return false;
+  }
+  if (json) {
+    fprintf(fp, "{\n  \"nInps\": %d,\n  \"nIter\": %d,\n  \"results\": [\n", nInps, nIter);
+    for (size_t i = 0; i < results.size(); ++i) {
+      const bench_result_t& r = results[i];
+      fprintf(fp, "    { \"scenario\": \"%s\", \"variant\": \"%s\", \"n_min\": %u, \"n_max\": %u, \"metric\": \"%s\", "
+        "\"median_ns\": %.3f, \"min_ns\": %.3f, \"max_ns\": %.3f, \"spread\": %.4f"
+        , r.scenario, r.variant.c_str(), r.n_min, r.n_max, r.metric
+        , r.median_ns, r.min_ns, r.max_ns, (r.max_ns - r.min_ns)/r.median_ns);
+      for (int e = 0; e < PerfCounters::MAX_EVENTS; ++e) {
+        if (r.perf[e] >= 0)
+          fprintf(fp, ", \"%s\": %.4f", perf_event_names[e], r.perf[e]);
+      }
+      fprintf(fp, " }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+  } else {
+    fprintf(fp, "scenario,variant,n_min,n_max,metric,median_ns,min_ns,max_ns,spread");
+    for (int e = 0; e < PerfCounters::MAX_EVENTS; ++e)
+      fprintf(fp, ",%s", perf_event_names[e]);
+    fprintf(fp, "\n");
+    for (const bench_result_t& r : results) {
+      fprintf(fp, "%s,%s,%u,%u,%s,%.3f,%.3f,%.3f,%.4f"
+        , r.scenario, r.variant.c_str(), r.n_min, r.n_max, r.metric
+        , r.median_ns, r.min_ns, r.max_ns, (r.max_ns - r.min_ns)/r.median_ns);
+      for (int e = 0; e < PerfCounters::MAX_EVENTS; ++e) { // empty field when not available
+        if (r.perf[e] >= 0)
+          fprintf(fp, ",%.4f", r.perf[e]);
+        else
+          fprintf(fp, ",");
+      }
+      fprintf(fp, "\n");
+    }
+  }
+  const bool ok = fclose(fp) == 0;
+  if (!ok)
+    perror(fname);
+  return ok;
+}
+
+// column_time_test - compare DivideDecimal68ByPowerOf10_Column() with scalar loop
+// All elements are divided by the largest exponent in expv[], that keeps every input in valid range
+static void column_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter)
+{
+  unsigned n = *std::max_element(expv, expv+nInps);
+  std::vector<uint64_t> srcPlanes(nInps*4);
+  std::vector<uint64_t> resPlanes(nInps*2);
+  std::vector<int>      retv(nInps);
+  const uint64_t* src[4];
+  uint64_t*       res[2];
+  for (int k = 0; k < 4; ++k) {
+    src[k] = &srcPlanes[nInps*k];
+    for (int i = 0; i < nInps; ++i)
+      srcPlanes[nInps*k+i] = inpv[i].w[k];
+  }
+  for (int k = 0; k < 2; ++k)
+    res[k] = &resPlanes[nInps*k];
+
+  std::vector<int64_t> tmVec(nIter);
+  uint64_t dummy = 0;
+  // Scalar loop with the same exponent
   for (int it = 0; it < nIter; ++it) {
-    uint64_t zero = vo_zero;
-    unsigned dummy_n = 0;
     std::chrono::steady_clock::time_point hres_t0 = std::chrono::steady_clock::now();
     for (int i = 0; i < nInps; ++i) {
       uint64_t y[2];
-      int r = DivideDecimal68ByPowerOf10(y, inpv[i].w, expv[i]+dummy_n);
+      int r = divide_fn(y, inpv[i].w, n);
       dummy ^= y[0];
       dummy ^= y[1];
       dummy ^= r;
-      dummy_n = ((dummy & zero) != 0);
     }
     std::chrono::steady_clock::time_point hres_t1 = std::chrono::steady_clock::now();
     tmVec[it] = std::chrono::duration_cast<std::chrono::microseconds>(hres_t1 - hres_t0).count();
   }
   std::nth_element(tmVec.begin(), tmVec.begin()+(nIter/2), tmVec.end());
-  int64_t tmMed_l = tmVec[nIter/2];
+  int64_t tmMed_s = tmVec[nIter/2];
 
-  int64_t ssum = 0;
-  unsigned s_min = expv[0];
-  unsigned s_max = expv[0];
-  for (int i = 0; i < nInps; ++i) {
-    unsigned s = expv[i];
-    ssum += s;
-    if (s_min > s) s_min = s;
-    if (s_max < s) s_max = s;
+  for (int it = 0; it < nIter; ++it) {
+    std::chrono::steady_clock::time_point hres_t0 = std::chrono::steady_clock::now();
+    DivideDecimal68ByPowerOf10_Column(res, retv.data(), src, n, nInps);
+    std::chrono::steady_clock::time_point hres_t1 = std::chrono::steady_clock::now();
+    tmVec[it] = std::chrono::duration_cast<std::chrono::microseconds>(hres_t1 - hres_t0).count();
+    dummy ^= res[0][it % nInps];
   }
+  std::nth_element(tmVec.begin(), tmVec.begin()+(nIter/2), tmVec.end());
+  int64_t tmMed_c = tmVec[nIter/2];
 
-  printf("rThr= %5.2f ns/call. %8lld usec total. Lat= %5.2f ns/call. %8lld usec total. Scale= %2u to %2u, average %5.2f.\n"
-    , tmMed_t*1e3/nInps
-    , tmMed_t
-    , tmMed_l*1e3/nInps
-    , tmMed_l
-    , s_min, s_max
-    , double(ssum)/nInps
+  printf("Column scale=%2u: scalar %5.2f ns/elem. column %5.2f ns/elem.\n"
+    , n
+    , tmMed_s*1e3/nInps
+    , tmMed_c*1e3/nInps
     );
 
   if (dummy==42)
     printf("Blue moon\n");
 }
 
+// Instantiations of DivideDecimal68ByPowerOf10<N> and of its timing loop, indexed by N
+template <unsigned N>
+static int fixed_divide(uint64_t result[2], const uint64_t src[4])
+{
+  return DivideDecimal68ByPowerOf10<N>(result, src);
+}
+
+// fixed_time_loops - throughput and latency loops for DivideDecimal68ByPowerOf10<N>
+// and for out-of-line DivideDecimal68ByPowerOf10_generic(..., N), same inputs, same loop structure.
+// The baseline is the generic variant, the algorithm the template is made of, not the public entry,
+// so both sides run the same algorithm and differ only in the immediates.
+// Return value: median times in usec - template throughput, template latency, out-of-line throughput, out-of-line latency
+template <unsigned N>
+static void fixed_time_loops(int64_t tmMed[4], const mp_uint256_t* inpv, int nInps, int nIter)
+{
+  std::vector<int64_t> tmVec(nIter);
+  uint64_t dummy = 0;
+  for (int k = 0; k < 4; ++k) {
+    const bool inl = k < 2;
+    const bool lat = k % 2 != 0;
+    for (int it = 0; it < nIter; ++it) {
+      uint64_t zero = lat ? vo_zero : 0;
+      int dummy_i = 0;
+      std::chrono::steady_clock::time_point hres_t0 = std::chrono::steady_clock::now();
+      if (inl) {
+        for (int i = 0; i < nInps; ++i) {
+          uint64_t y[2];
+          int r = DivideDecimal68ByPowerOf10<N>(y, inpv[i+dummy_i].w);
+          dummy ^= y[0];
+          dummy ^= y[1];
+          dummy ^= r;
+          if (lat) dummy_i = ((dummy & zero) != 0);
+        }
+      } else {
+        for (int i = 0; i < nInps; ++i) {
+          uint64_t y[2];
+          int r = DivideDecimal68ByPowerOf10_generic(y, inpv[i+dummy_i].w, N);
+          dummy ^= y[0];
+          dummy ^= y[1];
+          dummy ^= r;
+          if (lat) dummy_i = ((dummy & zero) != 0);
+        }
+      }
+      std::chrono::steady_clock::time_point hres_t1 = std::chrono::steady_clock::now();
+      tmVec[it] = std::chrono::duration_cast<std::chrono::microseconds>(hres_t1 - hres_t0).count();
+    }
+    std::nth_element(tmVec.begin(), tmVec.begin()+(nIter/2), tmVec.end());
+    tmMed[k] = tmVec[nIter/2];
+  }
+  if (dummy==42)
+    printf("Blue moon\n");
+}
+
+typedef int  (*fixed_divide_fn)(uint64_t result[2], const uint64_t src[4]);
+typedef void (*fixed_time_fn)(int64_t tmMed[4], const mp_uint256_t* inpv, int nInps, int nIter);
+template <unsigned... N>
+static void init_fixed_tabs(fixed_divide_fn* divTab, fixed_time_fn* timeTab, std::integer_sequence<unsigned, N...>)
+{
+  const fixed_divide_fn divs[]  = { fixed_divide<N>... };
+  const fixed_time_fn   times[] = { fixed_time_loops<N>... };
+  for (unsigned i = 0; i < sizeof...(N); ++i) {
+    divTab[i]  = divs[i];
+    timeTab[i] = times[i];
+  }
+}
+static fixed_divide_fn fixed_divide_tab[35];
+static fixed_time_fn   fixed_time_tab[35];
+
+static void InitFixedTables(void)
+{
+  init_fixed_tabs(fixed_divide_tab, fixed_time_tab, std::make_integer_sequence<unsigned, 35>());
+}
+
+// fixed_time_test - compare inlined DivideDecimal68ByPowerOf10<N> with out-of-line DivideDecimal68ByPowerOf10_generic()
+// N is the largest exponent in expv[], that keeps every input in valid range
+static void fixed_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter)
+{
+  unsigned n = *std::max_element(expv, expv+nInps);
+  int64_t tmMed[4];
+  fixed_time_tab[n](tmMed, inpv, nInps, nIter);
+  printf("Fixed  scale=%2u: template rThr= %5.2f Lat= %5.2f ns/call. out-of-line generic rThr= %5.2f Lat= %5.2f ns/call.\n"
+    , n
+    , tmMed[0]*1e3/nInps
+    , tmMed[1]*1e3/nInps
+    , tmMed[2]*1e3/nInps
+    , tmMed[3]*1e3/nInps
+    );
+}
+
 static int calc_ret(const mp_uint128_t& rem, const mp_uint128_t& divisor)
 {
   if ((rem.w[0] | rem.w[1])==0) return 0;
@@ -243,43 +1240,62 @@ static int calc_ret(const mp_uint128_t& rem, const mp_uint128_t& divisor)
   return 2;
 }
 
+// make_cases - build test inputs around expected quotient out.div
+// Return value: number of cases in x[], y[], r_ref[]
+static int make_cases(mp_uint256_t x[9], mp_uint128_t y[9], int r_ref[9], const mp_uint256_t& inp, unsigned n, const div_rem_t& out)
+{
+  static const int r_ref_init[9] = {0, 0,1,2,3, 0,1,2,3};
+  for (int k = 0; k < 9; ++k)
+    r_ref[k] = r_ref_init[k];
+  r_ref[0] = calc_ret(out.rem, pow10_tab[n]);
+  for (int k = 0; k < 5; ++k)
+    y[k] = out.div;
+  for (int k = 5; k < 9; ++k)
+    y[k] = mp_uint128_t(0, out.div.w[1]);
+  x[0] = mp_uint256_t(inp);
+  int nk = n > 0 ? 9 : 1;
+  if (nk > 1) {
+    x[1] = mulx(pow10_tab[n], out.div);
+    x[3] = add(x[1], pow10_tab[n].half());
+    x[2] = sub(x[3], 1);
+    x[4] = sub(add(x[1], pow10_tab[n]), 1);
+
+    x[5] = mulx(pow10_tab[n], y[5]);
+    x[6] = add(x[5], 1);
+    x[7] = add(x[5], pow10_tab[n].half());
+    x[8] = add(x[7], 1);
+  }
+  return nk;
+}
+
+// report_words - print prefix, then nw 64-bit words of w[] to stderr, most significant first, separated by ':'
+// Failure reports of all tests print their dividends and quotients with it, followed by test-specific fields
+static void report_words(const char* prefix, const uint64_t* w, int nw)
+{
+  fprintf(stderr, "%s", prefix);
+  for (int i = nw-1; i >= 0; --i)
+    fprintf(stderr, i == nw-1 ? "%016llx" : ":%016llx", (unsigned long long)w[i]);
+}
+
+static void report_failure(const mp_uint256_t& x, unsigned n, const uint64_t y_res[2], int r_res, const mp_uint128_t& y, int r_ref)
+{
+  report_words("",     x.w,   4); fprintf(stderr, " / 1E%u\n", n);
+  report_words("res: ", y_res, 2); fprintf(stderr, ",%d\n", r_res);
+  report_words("ref: ", y.w,   2); fprintf(stderr, ",%d\nFail!\n", r_ref);
+}
+
 static bool result_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps)
 {
   for (int i = 0; i < nInps; ++i) {
-    int r_ref[9] = {0, 0,1,2,3, 0,1,2,3};
-    r_ref[0] = calc_ret(outv[i].rem, pow10_tab[expv[i]]);
+    int r_ref[9];
     mp_uint256_t x[9];
     mp_uint128_t y[9];
-    for (int k = 0; k < 5; ++k)
-      y[k] = outv[i].div;
-    for (int k = 5; k < 9; ++k)
-      y[k] = mp_uint128_t(0, outv[i].div.w[1]);
-    x[0] = mp_uint256_t(inpv[i]);
-    int nk = expv[i] > 0 ? 9 : 1;
-    if (nk > 1) {
-      x[1] = mulx(pow10_tab[expv[i]], outv[i].div);
-      x[3] = add(x[1], pow10_tab[expv[i]].half());
-      x[2] = sub(x[3], 1);
-      x[4] = sub(add(x[1], pow10_tab[expv[i]]), 1);
-
-      x[5] = mulx(pow10_tab[expv[i]], y[5]);
-      x[6] = add(x[5], 1);
-      x[7] = add(x[5], pow10_tab[expv[i]].half());
-      x[8] = add(x[7], 1);
-    }
+    int nk = make_cases(x, y, r_ref, inpv[i], expv[i], outv[i]);
     for (int k = 0; k < nk; ++k) {
       uint64_t y_res[2];
-      int r_res = DivideDecimal68ByPowerOf10(y_res, x[k].w, expv[i]);
+      int r_res = divide_fn(y_res, x[k].w, expv[i]);
       if (y_res[0] != y[k].w[0] || y_res[1] != y[k].w[1] || r_res != r_ref[k]) {
-        fprintf(stderr,
-          "%016llx:%016llx:%016llx:%016llx / 1E%u\n"
-          "res: %016llx:%016llx,%d\n"
-          "ref: %016llx:%016llx,%d\n"
-          "Fail!\n"
-          ,x[k].w[3],x[k].w[2],x[k].w[1],x[k].w[0], expv[i]
-          ,y_res[1],y_res[0], r_res
-          ,y[k].w[1], y[k].w[0], r_ref[k]
-          );
+        report_failure(x[k], expv[i], y_res, r_res, y[k], r_ref[k]);
         return false;
       }
     }
@@ -287,11 +1303,1194 @@ static bool result_test(const mp_uint256_t* inpv, const unsigned* expv, const di
   return true;
 }
 
-static void InitPow10Table(void)
+// fuzz_mix - splitmix64 step, every fuzz case is generated from its own seed, so any case can be replayed alone
+static inline uint64_t fuzz_mix(uint64_t& s)
 {
-  mp_uint128_t val(1);
-  for (unsigned i = 0; i < sizeof(pow10_tab)/sizeof(pow10_tab[0]); ++i) {
-    pow10_tab[i] = val;
+  uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+// fuzz_case - build src = q*10**n + rem from case seed, q < 2**112, rem < 10**n
+// Quotients are uniform, log-distributed, small, around powers of ten or just below 2**112,
+// remainders are uniform or at the edges of rounding: 0, 1, half-1, half, half+1 and 10**n-1
+static void fuzz_case(mp_uint256_t& src, unsigned& n, div_rem_t& out, uint64_t caseSeed)
+{
+  uint64_t s = caseSeed;
+  uint64_t w[5];
+  for (int k = 0; k < 5; ++k)
+    w[k] = fuzz_mix(s);
+  const uint64_t MSK48 = (uint64_t(1) << 48) - 1;
+  n = unsigned(((w[0] & 0xFFFFFFFF) * 35) >> 32);
+
+  mp_uint128_t q;
+  switch ((w[0] >> 32) & 7) {
+    case 2: case 3: { // log-distributed, q < 2**bits
+      const unsigned bits = unsigned((w[0] >> 36) % 113);
+      q = bits <= 64 ? mp_uint128_t(bits ? w[1] >> (64 - bits) : 0)
+                     : mp_uint128_t(w[1], w[2] >> (128 - bits));
+    } break;
+    case 4: // just below 2**112, i.e. src just below the validity limit 10**n * 2**112
+      q = mp_uint128_t(~(w[1] & 0xFF), MSK48);
+      break;
+    case 5:
+      q = mp_uint128_t(w[1] & 0xFFFF);
+      break;
+    case 6: // 10**k-1, 10**k, 10**k+1
+      q = pow10_tab[w[1] % 34];
+      if (w[2] & 1)
+        q += mp_uint128_t((w[2] & 2) ? 1 : uint64_t(-1), (w[2] & 2) ? 0 : uint64_t(-1));
+      break;
+    default: // uniform on [0:2**112-1]
+      q = mp_uint128_t(w[1], w[2] & MSK48);
+      break;
+  }
+
+  mp_uint128_t rem = mulu(pow10_tab[n], mp_uint128_t(&w[3])); // uniform on [0:10**n-1]
+  if (n > 0) {
+    const mp_uint128_t half = pow10_tab[n].half();
+    const mp_uint128_t minus1(uint64_t(-1), uint64_t(-1));
+    switch ((w[0] >> 40) & 7) {
+      case 1: rem = uint64_t(0);                 break;
+      case 2: rem = half;                        break;
+      case 3: rem = half; rem += minus1;         break;
+      case 4: rem = half; rem += mp_uint128_t(1); break;
+      case 5: rem = pow10_tab[n]; rem += minus1; break;
+      case 6: rem = mp_uint128_t(1);             break;
+      default:                                   break;
+    }
+  }
+  out.div = q;
+  out.rem = rem;
+  src = add(mulx(pow10_tab[n], q), rem);
+}
+
+template <DivideDecimal68ByPowerOf10_fn DIV>
+static int round_by_hand(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned rnd_mode, unsigned sign, int* exp_adj);
+template <DivideDecimal68ByPowerOf10_fn DIV>
+static int normalize_by_hand(uint64_t result[2], const uint64_t src[4], unsigned p, unsigned rnd_mode, unsigned sign, unsigned* n_dropped);
+
+// Per-element adapters of the APIs that are not in variants_tab, for fuzz_test()
+// m selects rnd_mode = m%10/2, sign = m%2 and precision p = 1 + m/10%34 of the rounding APIs, aux returns their
+// exp_adj or n_dropped. Array APIs divide FUZZ_LANES copies of src, so vector bodies and their tails are covered.
+typedef int (*fuzz_api_fn)(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned m, int* aux);
+enum { FUZZ_LANES = 8 };
+
+// fuzz_pick_lane - result of the first lane that differs from lane 0, otherwise of lane 0
+static int fuzz_pick_lane(uint64_t result[2], const uint64_t y[][2], const int* r, unsigned count)
+{
+  unsigned k = 1;
+  while (k < count && y[k][0] == y[0][0] && y[k][1] == y[0][1] && r[k] == r[0])
+    ++k;
+  if (k == count)
+    k = 0;
+  result[0] = y[k][0];
+  result[1] = y[k][1];
+  return r[k];
+}
+
+static int fuzz_fastref(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned, int* aux)
+{
+  *aux = 0;
+  return DivideDecimal68ByPowerOf10_fastref(result, src, n);
+}
+
+static int fuzz_batch(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned, int* aux)
+{
+  uint64_t x[FUZZ_LANES][4], y[FUZZ_LANES][2];
+  unsigned nv[FUZZ_LANES];
+  int r[FUZZ_LANES];
+  for (int k = 0; k < FUZZ_LANES; ++k) {
+    memcpy(x[k], src, sizeof(x[k]));
+    nv[k] = n;
+  }
+  DivideDecimal68ByPowerOf10_Batch(y, r, x, nv, FUZZ_LANES);
+  *aux = 0;
+  return fuzz_pick_lane(result, y, r, FUZZ_LANES);
+}
+
+static int fuzz_bucketed(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned, int* aux)
+{
+  uint64_t x[FUZZ_LANES][4], y[FUZZ_LANES][2];
+  unsigned nv[FUZZ_LANES];
+  int r[FUZZ_LANES];
+  for (int k = 0; k < FUZZ_LANES; ++k) {
+    memcpy(x[k], src, sizeof(x[k]));
+    nv[k] = n;
+  }
+  DivideDecimal68ByPowerOf10_Bucketed(y, r, x, nv, FUZZ_LANES);
+  *aux = 0;
+  return fuzz_pick_lane(result, y, r, FUZZ_LANES);
+}
+
+static int fuzz_column(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned, int* aux)
+{
+  uint64_t xPlanes[4][FUZZ_LANES], yPlanes[2][FUZZ_LANES], y[FUZZ_LANES][2];
+  int r[FUZZ_LANES];
+  for (int k = 0; k < FUZZ_LANES; ++k)
+    for (int w = 0; w < 4; ++w)
+      xPlanes[w][k] = src[w];
+  const uint64_t* const xp[4] = { xPlanes[0], xPlanes[1], xPlanes[2], xPlanes[3] };
+  uint64_t* const       yp[2] = { yPlanes[0], yPlanes[1] };
+  DivideDecimal68ByPowerOf10_Column(yp, r, xp, n, FUZZ_LANES);
+  for (int k = 0; k < FUZZ_LANES; ++k) {
+    y[k][0] = yPlanes[0][k];
+    y[k][1] = yPlanes[1][k];
+  }
+  *aux = 0;
+  return fuzz_pick_lane(result, y, r, FUZZ_LANES);
+}
+
+static int fuzz_fixed(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned, int* aux)
+{
+  *aux = 0;
+  return fixed_divide_tab[n](result, src);
+}
+
+static int fuzz_x2(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned, int* aux)
+{
+  uint64_t x[2][4], y[2][2];
+  const unsigned nv[2] = { n, n };
+  int r[2];
+  memcpy(x[0], src, sizeof(x[0]));
+  memcpy(x[1], src, sizeof(x[1]));
+  DivideDecimal68ByPowerOf10_x2(y, r, x, nv);
+  *aux = 0;
+  return fuzz_pick_lane(result, y, r, 2);
+}
+
+static int fuzz_x4(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned, int* aux)
+{
+  uint64_t x[4][4], y[4][2];
+  const unsigned nv[4] = { n, n, n, n };
+  int r[4];
+  for (int k = 0; k < 4; ++k)
+    memcpy(x[k], src, sizeof(x[k]));
+  DivideDecimal68ByPowerOf10_x4(y, r, x, nv);
+  *aux = 0;
+  return fuzz_pick_lane(result, y, r, 4);
+}
+
+static int fuzz_round(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned m, int* aux)
+{
+  return DivideRoundDecimal68ByPowerOf10(result, src, n, m % 10 / 2, m % 2, aux);
+}
+
+static int fuzz_round_ref(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned m, int* aux)
+{
+  return round_by_hand<DivideDecimal68ByPowerOf10_fastref>(result, src, n, m % 10 / 2, m % 2, aux);
+}
+
+static int fuzz_round_digits(uint64_t result[2], const uint64_t src[4], unsigned, unsigned m, int* aux)
+{
+  unsigned n_dropped;
+  int ret = RoundDecimal68ToDigits(result, src, 1 + m / 10 % 34, m % 10 / 2, m % 2, &n_dropped);
+  *aux = int(n_dropped);
+  return ret;
+}
+
+static int fuzz_round_digits_ref(uint64_t result[2], const uint64_t src[4], unsigned, unsigned m, int* aux)
+{
+  unsigned n_dropped;
+  int ret = normalize_by_hand<DivideDecimal68ByPowerOf10_fastref>(result, src, 1 + m / 10 % 34, m % 10 / 2, m % 2, &n_dropped);
+  *aux = int(n_dropped);
+  return ret;
+}
+
+static const struct {
+  const char* name;
+  fuzz_api_fn fn;
+  fuzz_api_fn ref;
+} fuzz_api_tab[] = {
+  { "Batch",         fuzz_batch,        fuzz_fastref },
+  { "Column",        fuzz_column,       fuzz_fastref },
+  { "fixed<N>",      fuzz_fixed,        fuzz_fastref },
+  { "x2",            fuzz_x2,           fuzz_fastref },
+  { "x4",            fuzz_x4,           fuzz_fastref },
+  { "Bucketed",      fuzz_bucketed,     fuzz_fastref },
+  { "Round",         fuzz_round,        fuzz_round_ref },
+  { "RoundToDigits", fuzz_round_digits, fuzz_round_digits_ref },
+};
+
+// fuzz_failure_t - the first mismatch found by fuzz thread
+struct fuzz_failure_t {
+  uint64_t     caseIdx;  // uint64_t(-1) - no mismatch
+  const char*  variant;
+  bool         divmod;   // mismatch of DivMod, otherwise of Divide
+  bool         api;      // mismatch of an entry of fuzz_api_tab, ref holds the result of its reference
+  unsigned     m;        // rounding selector of fuzz_api_tab entry
+  int          aux_res, aux_ref;
+  mp_uint256_t src;
+  unsigned     n;
+  uint64_t     y_res[2], r_res[2];
+  int          ret_res;
+  div_rem_t    ref;
+  int          ret_ref;
+};
+
+// fuzz_test - differential test of every variant, incl. DivMod, and of every entry of fuzz_api_tab against DivideDecimal68ByPowerOf10_fastref
+// Cases are handed out to pinned threads in blocks, case k is generated from seed+k.
+// The fast reference itself is checked against the quotient and remainder the case was built from,
+// and on every FUZZ_SLOW_REF_STEP-th case against the slow DivideDecimal68ByPowerOf10_ref.
+// Progress and throughput are printed every 10 seconds, all threads stop on the first mismatch.
+static bool fuzz_test(uint64_t nCases, uint64_t seed, int nThreads)
+{
+  const unsigned ADX_FEATURES = DIVPOW10_CPU_BMI2 | DIVPOW10_CPU_ADX;
+  std::vector<unsigned> vars;
+  std::string varNames;
+  for (unsigned vi = 0; vi < sizeof(variants_tab)/sizeof(variants_tab[0]); ++vi) {
+    if (!variants_tab[vi].divmod) // references
+      continue;
+    if (variants_tab[vi].fn == DivideDecimal68ByPowerOf10_adx && (DivPow10_CpuFeatures() & ADX_FEATURES) != ADX_FEATURES)
+      continue;
+    vars.push_back(vi);
+    varNames += std::string(" ") + variants_tab[vi].name;
+  }
+  const unsigned nApis = sizeof(fuzz_api_tab)/sizeof(fuzz_api_tab[0]);
+  for (unsigned ai = 0; ai < nApis; ++ai)
+    varNames += std::string(" ") + fuzz_api_tab[ai].name;
+
+  std::vector<int> cpus;
+  for (const auto& c : physical_cores())
+    cpus.insert(cpus.end(), c.begin(), c.end());
+  if (nThreads == 0)
+    nThreads = cpus.empty() ? std::max(int(std::thread::hardware_concurrency()), 1) : int(cpus.size());
+  printf("Fuzz: %llu cases, seed=0x%016llx, %d threads, variants:%s\n"
+    , (unsigned long long)nCases, (unsigned long long)seed, nThreads, varNames.c_str());
+  fflush(stdout);
+
+  const uint64_t BLOCK = 4096;
+  const uint64_t FUZZ_SLOW_REF_STEP = 16;
+  std::atomic<uint64_t> nextCase(0);
+  std::atomic<uint64_t> casesDone(0);
+  std::atomic<int>      nRunning(nThreads);
+  std::atomic<bool>     stop(false);
+  std::vector<fuzz_failure_t> fail(nThreads);
+  std::vector<std::thread> threads;
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  for (int t = 0; t < nThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      if (!cpus.empty())
+        pin_current_thread(cpus[t % cpus.size()]);
+      fuzz_failure_t& f = fail[t];
+      f.caseIdx = uint64_t(-1);
+      while (!stop.load(std::memory_order_relaxed)) {
+        const uint64_t k0 = nextCase.fetch_add(BLOCK);
+        if (k0 >= nCases)
+          break;
+        const uint64_t k1 = std::min(k0 + BLOCK, nCases);
+        for (uint64_t k = k0; k < k1 && f.caseIdx == uint64_t(-1); ++k) {
+          fuzz_case(f.src, f.n, f.ref, seed + k);
+          uint64_t y_ref[2];
+          f.ret_ref = calc_ret(f.ref.rem, pow10_tab[f.n]);
+          int ret = DivideDecimal68ByPowerOf10_fastref(y_ref, f.src.w, f.n);
+          const char* refName = "fastref";
+          if (k % FUZZ_SLOW_REF_STEP == 0 && y_ref[0] == f.ref.div.w[0] && y_ref[1] == f.ref.div.w[1] && ret == f.ret_ref) {
+            ret = DivideDecimal68ByPowerOf10_ref(y_ref, f.src.w, f.n);
+            refName = "reference";
+          }
+          if (y_ref[0] != f.ref.div.w[0] || y_ref[1] != f.ref.div.w[1] || ret != f.ret_ref) {
+            f.caseIdx = k;
+            f.variant = refName;
+            f.divmod  = false;
+            f.api     = false;
+            f.y_res[0] = y_ref[0]; f.y_res[1] = y_ref[1];
+            f.ret_res = ret;
+            break;
+          }
+          for (unsigned vi : vars) {
+            uint64_t y[2], r[2] = { 0, 0 };
+            ret = variants_tab[vi].fn(y, f.src.w, f.n);
+            bool divmod = false;
+            if (y[0] == y_ref[0] && y[1] == y_ref[1] && ret == f.ret_ref) {
+              divmod = true;
+              ret = variants_tab[vi].divmod(y, r, f.src.w, f.n);
+              if (y[0] == y_ref[0] && y[1] == y_ref[1] && ret == f.ret_ref && r[0] == f.ref.rem.w[0] && r[1] == f.ref.rem.w[1])
+                continue;
+            }
+            f.caseIdx = k;
+            f.variant = variants_tab[vi].name;
+            f.divmod  = divmod;
+            f.api     = false;
+            f.y_res[0] = y[0]; f.y_res[1] = y[1];
+            f.r_res[0] = r[0]; f.r_res[1] = r[1];
+            f.ret_res = ret;
+            break;
+          }
+          const unsigned m = unsigned((seed + k) % 340); // from case seed, so --seed reproduces it
+          for (unsigned ai = 0; ai < nApis && f.caseIdx == uint64_t(-1); ++ai) {
+            uint64_t y[2], y_api[2];
+            int aux, aux_ref;
+            ret = fuzz_api_tab[ai].fn(y, f.src.w, f.n, m, &aux);
+            const int ret_api = fuzz_api_tab[ai].ref(y_api, f.src.w, f.n, m, &aux_ref);
+            if (y[0] == y_api[0] && y[1] == y_api[1] && ret == ret_api && aux == aux_ref)
+              continue;
+            f.caseIdx = k;
+            f.variant = fuzz_api_tab[ai].name;
+            f.divmod  = false;
+            f.api     = true;
+            f.m       = m;
+            f.y_res[0] = y[0]; f.y_res[1] = y[1];
+            f.ret_res = ret;
+            f.aux_res = aux;
+            f.aux_ref = aux_ref;
+            f.ref.div = mp_uint128_t(y_api);
+            f.ret_ref = ret_api;
+          }
+        }
+        if (f.caseIdx != uint64_t(-1)) {
+          stop.store(true);
+          break;
+        }
+        casesDone.fetch_add(k1 - k0, std::memory_order_relaxed);
+      }
+      nRunning.fetch_sub(1);
+    });
+  }
+
+  // the main thread only reports progress
+  std::chrono::steady_clock::time_point tReport = t0;
+  while (nRunning.load() > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::chrono::steady_clock::time_point tNow = std::chrono::steady_clock::now();
+    if (tNow - tReport >= std::chrono::seconds(10)) {
+      tReport = tNow;
+      const double sec = std::chrono::duration<double>(tNow - t0).count();
+      const uint64_t done = casesDone.load();
+      printf("Fuzz: %llu cases (%.1f%%), %.1f s, %.2f Mcases/s\n"
+        , (unsigned long long)done, done*100.0/nCases, sec, done*1e-6/sec);
+      fflush(stdout);
+    }
+  }
+  for (auto& th : threads)
+    th.join();
+  const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  const fuzz_failure_t* first = 0;
+  for (const auto& f : fail)
+    if (f.caseIdx != uint64_t(-1) && (!first || f.caseIdx < first->caseIdx))
+      first = &f;
+  const uint64_t done = casesDone.load();
+  if (!first) {
+    printf("Fuzz: %llu cases, %.1f s, %.2f Mcases/s, %.2f Mcalls/s. o.k.\n"
+      , (unsigned long long)done, sec, done*1e-6/sec, done*(1 + vars.size()*2 + nApis)*1e-6/sec);
+    return true;
+  }
+
+  fprintf(stderr, "Fuzz: %s %s mismatch at case %llu of seed=0x%016llx, after %llu cases in %.1f s.\n"
+    , first->variant, first->api ? "API" : first->divmod ? "DivMod" : "Divide", (unsigned long long)first->caseIdx
+    , (unsigned long long)seed, (unsigned long long)done, sec);
+  report_failure(first->src, first->n, first->y_res, first->ret_res, first->ref.div, first->ret_ref);
+  if (first->api)
+    fprintf(stderr, "rnd_mode=%u sign=%u p=%u, exp_adj/n_dropped res: %d ref: %d\n"
+      , first->m % 10 / 2, first->m % 2, 1 + first->m / 10 % 34, first->aux_res, first->aux_ref);
+  if (first->divmod)
+    fprintf(stderr, "remainder res: %016llx:%016llx ref: %016llx:%016llx\n"
+      , (unsigned long long)first->r_res[1], (unsigned long long)first->r_res[0]
+      , (unsigned long long)first->ref.rem.w[1], (unsigned long long)first->ref.rem.w[0]);
+  fprintf(stderr, "Reproduce with: divpow10_test --fuzz=1 --seed=0x%016llx\n", (unsigned long long)(seed + first->caseIdx));
+  return false;
+}
+
+// divmod_test - check quotient, return value and remainder of DivModDecimal68ByPowerOf10() on the same cases as result_test()
+static bool divmod_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps)
+{
+  for (int i = 0; i < nInps; ++i) {
+    int r_ref[9];
+    mp_uint256_t x[9];
+    mp_uint128_t y[9];
+    unsigned n = expv[i];
+    int nk = make_cases(x, y, r_ref, inpv[i], n, outv[i]);
+    for (int k = 0; k < nk; ++k) {
+      mp_uint256_t rem_ref = sub(x[k], mulx(pow10_tab[n], y[k]));
+      uint64_t y_res[2], rem_res[2];
+      int r_res = divmod_fn(y_res, rem_res, x[k].w, n);
+      if (y_res[0] != y[k].w[0] || y_res[1] != y[k].w[1] || r_res != r_ref[k]) {
+        report_failure(x[k], n, y_res, r_res, y[k], r_ref[k]);
+        return false;
+      }
+      if (rem_res[0] != rem_ref.w[0] || rem_res[1] != rem_ref.w[1]) {
+        report_words("",         x[k].w,    4); fprintf(stderr, " / 1E%u\n", n);
+        report_words("rem res: ", rem_res,   2); fprintf(stderr, "\n");
+        report_words("rem ref: ", rem_ref.w, 2); fprintf(stderr, "\nFail!\n");
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// inc_by_hand - rounding increment from rounding code and LS word of the quotient, with branches
+static int inc_by_hand(int code, uint64_t q0, unsigned rnd_mode, unsigned sign)
+{
+  switch (rnd_mode) {
+    case DIVPOW10_ROUND_NEAREST_EVEN: return code == 3 || (code == 2 && (q0 & 1));
+    case DIVPOW10_ROUND_NEAREST_AWAY: return code >= 2;
+    case DIVPOW10_ROUND_DOWN:         return code != 0 && sign != 0;
+    case DIVPOW10_ROUND_UP:           return code != 0 && sign == 0;
+  }
+  return 0;
+}
+
+// round_by_hand - DivideRoundDecimal68ByPowerOf10() composed from DIV, DivideDecimal68ByPowerOf10() or a reference, the usual way
+template <DivideDecimal68ByPowerOf10_fn DIV>
+static int round_by_hand(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned rnd_mode, unsigned sign, int* exp_adj)
+{
+  int code = DIV(result, src, n);
+  *exp_adj = 0;
+  if (inc_by_hand(code, result[0], rnd_mode, sign)) {
+    result[0] += 1;
+    result[1] += (result[0] == 0);
+    if (result[0] == pow10_tab[34].w[0] && result[1] == pow10_tab[34].w[1]) {
+      result[0] = pow10_tab[33].w[0];
+      result[1] = pow10_tab[33].w[1];
+      *exp_adj = 1;
+    }
+  }
+  return code != 0;
+}
+
+// round_test - check DivideRoundDecimal68ByPowerOf10() in all rounding modes on the same cases as result_test(),
+// plus quotients that round to 10**34
+static bool round_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps)
+{
+  for (int i = 0; i < nInps + 34; ++i) {
+    int r_ref[9];
+    mp_uint256_t x[9];
+    mp_uint128_t y[9];
+    unsigned n;
+    int nk;
+    if (i < nInps) {
+      n = expv[i];
+      nk = make_cases(x, y, r_ref, inpv[i], n, outv[i]);
+    } else {
+      n = i - nInps + 1;
+      div_rem_t out = { mp_uint128_t(pow10_tab[34].w[0] - 1, pow10_tab[34].w[1]), uint64_t(0) }; // 10**34 is not multiple of 2**64
+      nk = make_cases(x, y, r_ref, mulx(pow10_tab[n], out.div), n, out);
+    }
+    for (int k = 0; k < nk; ++k) {
+      for (unsigned m = 0; m < 10; ++m) {
+        unsigned rnd_mode = m >> 1, sign = m & 1;
+        uint64_t y_res[2], y_ref[2];
+        int adj_res, adj_ref;
+        int r_res = DivideRoundDecimal68ByPowerOf10(y_res, x[k].w, n, rnd_mode, sign, &adj_res);
+        int r_ref = round_by_hand<DivideDecimal68ByPowerOf10>(y_ref, x[k].w, n, rnd_mode, sign, &adj_ref);
+        if (y_res[0] != y_ref[0] || y_res[1] != y_ref[1] || r_res != r_ref || adj_res != adj_ref) {
+          report_words("",     x[k].w, 4); fprintf(stderr, " / 1E%u, rnd_mode=%u, sign=%u\n", n, rnd_mode, sign);
+          report_words("res: ", y_res,  2); fprintf(stderr, ",%d,%d\n", r_res, adj_res);
+          report_words("ref: ", y_ref,  2); fprintf(stderr, ",%d,%d\nFail!\n", r_ref, adj_ref);
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// round_time_test - compare DivideRoundDecimal68ByPowerOf10() with rounding composed by hand
+// Rounding mode and sign are random for every element
+static void round_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter)
+{
+  std::mt19937_64 rndGen(1);
+  std::vector<unsigned> modev(nInps);
+  for (int i = 0; i < nInps; ++i) {
+    uint64_t w = rndGen();
+    modev[i] = unsigned(((w & 0xFFFFFFFF)*5 >> 32) << 1 | (w >> 63)); // rnd_mode << 1 | sign
+  }
+
+  typedef int (*round_fn)(uint64_t result[2], const uint64_t src[4], unsigned n, unsigned rnd_mode, unsigned sign, int* exp_adj);
+  static const round_fn fn_tab[2] = { DivideRoundDecimal68ByPowerOf10, round_by_hand<DivideDecimal68ByPowerOf10> };
+  std::vector<int64_t> tmVec(nIter);
+  int64_t tmMed[2];
+  uint64_t dummy = 0;
+  for (int fi = 0; fi < 2; ++fi) {
+    round_fn fn = fn_tab[fi];
+    for (int it = 0; it < nIter; ++it) {
+      std::chrono::steady_clock::time_point hres_t0 = std::chrono::steady_clock::now();
+      for (int i = 0; i < nInps; ++i) {
+        uint64_t y[2];
+        int adj;
+        int r = fn(y, inpv[i].w, expv[i], modev[i] >> 1, modev[i] & 1, &adj);
+        dummy ^= y[0];
+        dummy ^= y[1];
+        dummy ^= r + adj;
+      }
+      std::chrono::steady_clock::time_point hres_t1 = std::chrono::steady_clock::now();
+      tmVec[it] = std::chrono::duration_cast<std::chrono::microseconds>(hres_t1 - hres_t0).count();
+    }
+    std::nth_element(tmVec.begin(), tmVec.begin()+(nIter/2), tmVec.end());
+    tmMed[fi] = tmVec[nIter/2];
+  }
+
+  printf("Round: fused= %5.2f ns/call. by hand= %5.2f ns/call.\n"
+    , tmMed[0]*1e3/nInps
+    , tmMed[1]*1e3/nInps
+    );
+
+  if (dummy==42)
+    printf("Blue moon\n");
+}
+
+// clz64 - number of leading zero bits, x != 0
+static inline unsigned clz64(uint64_t x)
+{
+#ifdef _MSC_VER
+  unsigned long idx;
+  _BitScanReverse64(&idx, x);
+  return 63 - (unsigned)idx;
+#else
+  return (unsigned)__builtin_clzll(x);
+#endif
+}
+
+// digits_by_hand - number of decimal digits in src, 0 for src=0, the way callers count them before division:
+// skip zero words, bit length, estimate and comparison against 10**(estimate+1)
+static unsigned digits_by_hand(const uint64_t src[4])
+{
+  int wi = 3;
+  while (wi >= 0 && src[wi] == 0)
+    --wi;
+  if (wi < 0)
+    return 0;
+  unsigned nbits = wi*64 + 64 - clz64(src[wi]);
+  unsigned d = (nbits-1)*1233 >> 12; // floor(log10(2**(nbits-1)))
+  const uint64_t* p = pow10_wide_tab[d+1].w;
+  for (wi = 3; wi >= 0; --wi) {
+    if (src[wi] != p[wi])
+      return src[wi] > p[wi] ? d+2 : d+1;
+  }
+  return d+2;
+}
+
+// normalize_by_hand - RoundDecimal68ToDigits() composed from digit count and DIV, DivideDecimal68ByPowerOf10() or a reference
+template <DivideDecimal68ByPowerOf10_fn DIV>
+static int normalize_by_hand(uint64_t result[2], const uint64_t src[4], unsigned p, unsigned rnd_mode, unsigned sign, unsigned* n_dropped)
+{
+  const unsigned d = digits_by_hand(src);
+  unsigned n = d > p ? d - p : 0;
+  int code;
+  if (n <= 34) {
+    code = DIV(result, src, n);
+  } else {
+    uint64_t q34[4] = { 0, 0, 0, 0 };
+    const int code1 = DIV(q34, src, 34);
+    code = DIV(result, q34, n - 34) | (code1 != 0);
+  }
+  if (inc_by_hand(code, result[0], rnd_mode, sign)) {
+    result[0] += 1;
+    result[1] += (result[0] == 0);
+    if (result[0] == pow10_tab[p].w[0] && result[1] == pow10_tab[p].w[1]) {
+      result[0] = pow10_tab[p-1].w[0];
+      result[1] = pow10_tab[p-1].w[1];
+      n += 1;
+    }
+  }
+  *n_dropped = n;
+  return code != 0;
+}
+
+// normalize_test - check RoundDecimal68ToDigits() against normalize_by_hand() in all rounding modes,
+// on products of two coefficients of random length and on powers of ten +-1, then compare their speed
+// for p=34 (decimal128) and p=16 (decimal64)
+static bool normalize_test(int nInps, int nIter)
+{
+  std::mt19937_64 rndGen(68);
+  std::vector<mp_uint256_t> inpv(nInps);
+  std::vector<unsigned>     modev(nInps);
+  for (int i = 0; i < nInps; ++i) {
+    uint64_t w = rndGen();
+    const unsigned da = 1 + unsigned(((w & 0xFFFFFFFF)*34) >> 32);
+    const unsigned db = 1 + unsigned(((w >> 32)*34) >> 32);
+    const mp_uint128_t a = mulu(pow10_tab[da], mp_uint128_t(rndGen(), rndGen()));
+    const mp_uint128_t b = mulu(pow10_tab[db], mp_uint128_t(rndGen(), rndGen()));
+    inpv[i] = mulx(a, b);
+    w = rndGen();
+    modev[i] = unsigned(((w & 0xFFFFFFFF)*5 >> 32) << 1 | (w >> 63)); // rnd_mode << 1 | sign
+  }
+
+  for (int i = 0; i < nInps + 69*3; ++i) {
+    mp_uint256_t x;
+    if (i < nInps) {
+      x = inpv[i];
+    } else {
+      const int k = (i - nInps) / 3;
+      x = pow10_wide_tab[k];
+      switch ((i - nInps) % 3) {
+        case 0: x = sub(x, mp_uint256_t(1)); break; // all nines, rounding carries to the next power
+        case 1: break;
+        case 2: x = add(x, mp_uint256_t(1)); break;
+      }
+    }
+    const unsigned p_tab[3] = { 34, 16, 1 + unsigned(i % 34) };
+    for (int pi = 0; pi < 3; ++pi) {
+      const unsigned p = p_tab[pi];
+      for (unsigned m = 0; m < 10; ++m) {
+        unsigned rnd_mode = m >> 1, sign = m & 1;
+        uint64_t y_res[2], y_ref[2];
+        unsigned n_res, n_ref;
+        int r_res = RoundDecimal68ToDigits(y_res, x.w, p, rnd_mode, sign, &n_res);
+        int r_ref = normalize_by_hand<DivideDecimal68ByPowerOf10>(y_ref, x.w, p, rnd_mode, sign, &n_ref);
+        if (y_res[0] != y_ref[0] || y_res[1] != y_ref[1] || r_res != r_ref || n_res != n_ref
+            || cmp(mp_uint128_t(y_ref), pow10_tab[p]) >= 0) {
+          report_words("",     x.w,   4); fprintf(stderr, " to %u digits, rnd_mode=%u, sign=%u\n", p, rnd_mode, sign);
+          report_words("res: ", y_res, 2); fprintf(stderr, ",%d,%u\n", r_res, n_res);
+          report_words("ref: ", y_ref, 2); fprintf(stderr, ",%d,%u\nFail!\n", r_ref, n_ref);
+          return false;
+        }
+      }
+    }
+  }
+
+  typedef int (*normalize_fn)(uint64_t result[2], const uint64_t src[4], unsigned p, unsigned rnd_mode, unsigned sign, unsigned* n_dropped);
+  static const normalize_fn fn_tab[2] = { RoundDecimal68ToDigits, normalize_by_hand<DivideDecimal68ByPowerOf10> };
+  static const unsigned p_tab[2] = { 34, 16 };
+  std::vector<int64_t> tmVec(nIter);
+  uint64_t dummy = 0;
+  for (int pi = 0; pi < 2; ++pi) {
+    const unsigned p = p_tab[pi];
+    int64_t tmMed[2];
+    for (int fi = 0; fi < 2; ++fi) {
+      normalize_fn fn = fn_tab[fi];
+      for (int it = 0; it < nIter; ++it) {
+        std::chrono::steady_clock::time_point hres_t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < nInps; ++i) {
+          uint64_t y[2];
+          unsigned nd;
+          int r = fn(y, inpv[i].w, p, modev[i] >> 1, modev[i] & 1, &nd);
+          dummy ^= y[0];
+          dummy ^= y[1];
+          dummy ^= r + nd;
+        }
+        std::chrono::steady_clock::time_point hres_t1 = std::chrono::steady_clock::now();
+        tmVec[it] = std::chrono::duration_cast<std::chrono::microseconds>(hres_t1 - hres_t0).count();
+      }
+      std::nth_element(tmVec.begin(), tmVec.begin()+(nIter/2), tmVec.end());
+      tmMed[fi] = tmVec[nIter/2];
+    }
+    printf("Normalize p=%u: fused= %5.2f ns/call. two-step= %5.2f ns/call.\n"
+      , p
+      , tmMed[0]*1e3/nInps
+      , tmMed[1]*1e3/nInps
+      );
+  }
+
+  if (dummy==42)
+    printf("Blue moon\n");
+  return true;
+}
+
+// batch_test - check DivideDecimal68ByPowerOf10_Batch() and DivideDecimal68ByPowerOf10_Bucketed() on the same cases as result_test()
+static bool batch_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps)
+{
+  std::vector<mp_uint256_t> xv;
+  std::vector<mp_uint128_t> yv;
+  std::vector<unsigned>     nv;
+  std::vector<int>          rv;
+  for (int i = 0; i < nInps; ++i) {
+    int r_ref[9];
+    mp_uint256_t x[9];
+    mp_uint128_t y[9];
+    int nk = make_cases(x, y, r_ref, inpv[i], expv[i], outv[i]);
+    for (int k = 0; k < nk; ++k) {
+      xv.push_back(x[k]);
+      yv.push_back(y[k]);
+      nv.push_back(expv[i]);
+      rv.push_back(r_ref[k]);
+    }
+  }
+  // exponents out of range
+  for (unsigned n = 35; n < 40; ++n) {
+    xv.push_back(inpv[0]);
+    yv.push_back(mp_uint128_t(inpv[0].w));
+    nv.push_back(n);
+    rv.push_back(0);
+  }
+
+  size_t nCases = xv.size();
+  std::vector<mp_uint128_t> resv(nCases);
+  std::vector<int>          retv(nCases);
+  for (int bi = 0; bi < 2; ++bi) {
+    if (bi == 0)
+      DivideDecimal68ByPowerOf10_Batch(&resv[0].w, retv.data(), &xv[0].w, nv.data(), nCases);
+    else
+      DivideDecimal68ByPowerOf10_Bucketed(&resv[0].w, retv.data(), &xv[0].w, nv.data(), nCases);
+    for (size_t i = 0; i < nCases; ++i) {
+      if (resv[i].w[0] != yv[i].w[0] || resv[i].w[1] != yv[i].w[1] || retv[i] != rv[i]) {
+        fprintf(stderr, bi == 0 ? "Batch: " : "Bucketed: ");
+        report_failure(xv[i], nv[i], resv[i].w, retv[i], yv[i], rv[i]);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// lanes_test - check DivideDecimal68ByPowerOf10_x2() and DivideDecimal68ByPowerOf10_x4() on the same cases as result_test(),
+// mixed with exponents out of range, so that lanes of one call take different paths
+static bool lanes_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps)
+{
+  std::vector<mp_uint256_t> xv;
+  std::vector<mp_uint128_t> yv;
+  std::vector<unsigned>     nv;
+  std::vector<int>          rv;
+  for (int i = 0; i < nInps; ++i) {
+    int r_ref[9];
+    mp_uint256_t x[9];
+    mp_uint128_t y[9];
+    int nk = make_cases(x, y, r_ref, inpv[i], expv[i], outv[i]);
+    for (int k = 0; k < nk; ++k) {
+      xv.push_back(x[k]);
+      yv.push_back(y[k]);
+      nv.push_back(expv[i]);
+      rv.push_back(r_ref[k]);
+    }
+    if (i % 7 == 0) { // exponent out of range, result is src
+      xv.push_back(inpv[i]);
+      yv.push_back(mp_uint128_t(inpv[i].w));
+      nv.push_back(i % 2 ? 35 : unsigned(-1));
+      rv.push_back(0);
+    }
+  }
+  while (xv.size() % 4 != 0) {
+    xv.push_back(inpv[0]);
+    yv.push_back(mp_uint128_t(inpv[0].w));
+    nv.push_back(36);
+    rv.push_back(0);
+  }
+
+  for (size_t i = 0; i < xv.size(); i += 4) {
+    uint64_t y2[4][2], y4[4][2];
+    int r2[4], r4[4];
+    DivideDecimal68ByPowerOf10_x2(&y2[0], &r2[0], &xv[i+0].w, &nv[i+0]);
+    DivideDecimal68ByPowerOf10_x2(&y2[2], &r2[2], &xv[i+2].w, &nv[i+2]);
+    DivideDecimal68ByPowerOf10_x4(y4, r4, &xv[i].w, &nv[i]);
+    for (int k = 0; k < 4; ++k) {
+      const mp_uint128_t& y = yv[i+k];
+      if (y2[k][0] != y.w[0] || y2[k][1] != y.w[1] || r2[k] != rv[i+k]) {
+        fprintf(stderr, "x2 lane %d: ", k % 2);
+        report_failure(xv[i+k], nv[i+k], y2[k], r2[k], y, rv[i+k]);
+        return false;
+      }
+      if (y4[k][0] != y.w[0] || y4[k][1] != y.w[1] || r4[k] != rv[i+k]) {
+        fprintf(stderr, "x4 lane %d: ", k);
+        report_failure(xv[i+k], nv[i+k], y4[k], r4[k], y, rv[i+k]);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// bucket_time_test - DivideDecimal68ByPowerOf10_Bucketed() against a plain loop of the implementation under test,
+// a plain loop of DivideDecimal68ByPowerOf10_opt(), that has the same kernels, but selects them per call,
+// and DivideDecimal68ByPowerOf10_Batch(), over the whole input array
+static void bucket_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter)
+{
+  std::vector<mp_uint128_t> resv(nInps);
+  std::vector<int>          retv(nInps);
+  std::vector<int64_t> tmVec(nIter);
+  int64_t tmMed[4]; // loop, opt loop, Batch, Bucketed
+  uint64_t dummy = 0;
+  for (int fi = 0; fi < 4; ++fi) {
+    for (int it = 0; it < nIter; ++it) {
+      std::chrono::steady_clock::time_point hres_t0 = std::chrono::steady_clock::now();
+      switch (fi) {
+        case 0:
+          for (int i = 0; i < nInps; ++i)
+            retv[i] = divide_fn(resv[i].w, inpv[i].w, expv[i]);
+          break;
+        case 1:
+          for (int i = 0; i < nInps; ++i)
+            retv[i] = DivideDecimal68ByPowerOf10_opt(resv[i].w, inpv[i].w, expv[i]);
+          break;
+        case 2:
+          DivideDecimal68ByPowerOf10_Batch(&resv[0].w, retv.data(), &inpv[0].w, expv, nInps);
+          break;
+        default:
+          DivideDecimal68ByPowerOf10_Bucketed(&resv[0].w, retv.data(), &inpv[0].w, expv, nInps);
+          break;
+      }
+      std::chrono::steady_clock::time_point hres_t1 = std::chrono::steady_clock::now();
+      tmVec[it] = std::chrono::duration_cast<std::chrono::microseconds>(hres_t1 - hres_t0).count();
+      dummy ^= resv[it % nInps].w[0] ^ retv[it % nInps];
+    }
+    std::nth_element(tmVec.begin(), tmVec.begin()+(nIter/2), tmVec.end());
+    tmMed[fi] = tmVec[nIter/2];
+  }
+
+  printf("Bucketed: loop= %5.2f ns/elem. opt loop= %5.2f ns/elem. Batch= %5.2f ns/elem. bucketed= %5.2f ns/elem, %4.2fx of loop, %4.2fx of opt loop.\n"
+    , tmMed[0]*1e3/nInps
+    , tmMed[1]*1e3/nInps
+    , tmMed[2]*1e3/nInps
+    , tmMed[3]*1e3/nInps
+    , tmMed[3] > 0 ? double(tmMed[0])/tmMed[3] : 0.0
+    , tmMed[3] > 0 ? double(tmMed[1])/tmMed[3] : 0.0
+    );
+
+  if (dummy==42)
+    printf("Blue moon\n");
+}
+
+// lanes_time_test - DivideDecimal68ByPowerOf10_x2() and DivideDecimal68ByPowerOf10_x4() against back-to-back single calls
+// The inputs are taken in groups of 4 independent divisions. In latency mode exponents of the next group depend
+// on all results of the previous group, like in time_test(), so every group is one step of 4 parallel dependency chains.
+static void lanes_time_test(const mp_uint256_t* inpv, const unsigned* expv, int nInps, int nIter)
+{
+  const int nGrp = nInps & ~3;
+  if (nGrp == 0)
+    return;
+  std::vector<int64_t> tmVec(nIter);
+  int64_t tmMed[2][3]; // [rThr, Lat][single, x2, x4]
+  for (int lat = 0; lat < 2; ++lat) {
+    for (int fi = 0; fi < 3; ++fi) {
+      auto call = [=](int i, unsigned dn) {
+        const unsigned n[4] = { expv[i]+dn, expv[i+1]+dn, expv[i+2]+dn, expv[i+3]+dn };
+        uint64_t y[4][2];
+        int r[4];
+        switch (fi) {
+          case 0:
+            for (int k = 0; k < 4; ++k)
+              r[k] = DivideDecimal68ByPowerOf10(y[k], inpv[i+k].w, n[k]);
+            break;
+          case 1:
+            DivideDecimal68ByPowerOf10_x2(&y[0], &r[0], &inpv[i+0].w, &n[0]);
+            DivideDecimal68ByPowerOf10_x2(&y[2], &r[2], &inpv[i+2].w, &n[2]);
+            break;
+          default:
+            DivideDecimal68ByPowerOf10_x4(y, r, &inpv[i].w, n);
+            break;
+        }
+        uint64_t acc = 0;
+        for (int k = 0; k < 4; ++k)
+          acc ^= y[k][0] ^ y[k][1] ^ uint64_t(r[k]);
+        return acc;
+      };
+      if (lat)
+        time_loops<true>(tmVec, nGrp, 4, call);
+      else
+        time_loops<false>(tmVec, nGrp, 4, call);
+      tmMed[lat][fi] = median_ns(tmVec);
+    }
+  }
+
+  for (int lat = 0; lat < 2; ++lat) {
+    const int64_t* tm = tmMed[lat];
+    printf("Lanes %s: single= %5.2f ns/div. x2= %5.2f ns/div, %4.2fx. x4= %5.2f ns/div, %4.2fx.\n"
+      , lat ? "Lat " : "rThr"
+      , double(tm[0])/nGrp
+      , double(tm[1])/nGrp, tm[1] > 0 ? double(tm[0])/tm[1] : 0.0
+      , double(tm[2])/nGrp, tm[2] > 0 ? double(tm[0])/tm[2] : 0.0
+      );
+  }
+}
+
+// column_test - check DivideDecimal68ByPowerOf10_Column() on the same cases as result_test(), grouped by exponent
+static bool column_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps)
+{
+  for (unsigned n = 0; n < 36; ++n) {
+    std::vector<uint64_t>     xPlanes[4];
+    std::vector<mp_uint256_t> xv;
+    std::vector<mp_uint128_t> yv;
+    std::vector<int>          rv;
+    for (int i = 0; i < nInps; ++i) {
+      if (expv[i] != n && !(n == 35 && i < 100))
+        continue;
+      int r_ref[9];
+      mp_uint256_t x[9];
+      mp_uint128_t y[9];
+      int nk = make_cases(x, y, r_ref, inpv[i], expv[i], outv[i]);
+      if (n == 35) { // exponent out of range
+        nk = 1;
+        y[0] = mp_uint128_t(x[0].w);
+        r_ref[0] = 0;
+      }
+      for (int k = 0; k < nk; ++k) {
+        for (int wi = 0; wi < 4; ++wi)
+          xPlanes[wi].push_back(x[k].w[wi]);
+        xv.push_back(x[k]);
+        yv.push_back(y[k]);
+        rv.push_back(r_ref[k]);
+      }
+    }
+    size_t nCases = xv.size();
+    if (nCases == 0)
+      continue;
+    std::vector<uint64_t> resPlanes[2] = { std::vector<uint64_t>(nCases), std::vector<uint64_t>(nCases) };
+    std::vector<int>      retv(nCases);
+    const uint64_t* src[4] = { xPlanes[0].data(), xPlanes[1].data(), xPlanes[2].data(), xPlanes[3].data() };
+    uint64_t*       res[2] = { resPlanes[0].data(), resPlanes[1].data() };
+    DivideDecimal68ByPowerOf10_Column(res, retv.data(), src, n, nCases);
+    for (size_t i = 0; i < nCases; ++i) {
+      if (res[0][i] != yv[i].w[0] || res[1][i] != yv[i].w[1] || retv[i] != rv[i]) {
+        uint64_t y_res[2] = { res[0][i], res[1][i] };
+        fprintf(stderr, "Column: ");
+        report_failure(xv[i], n, y_res, retv[i], yv[i], rv[i]);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// fixed_test - check DivideDecimal68ByPowerOf10<N> on the same cases as result_test()
+static bool fixed_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps)
+{
+  for (int i = 0; i < nInps; ++i) {
+    int r_ref[9];
+    mp_uint256_t x[9];
+    mp_uint128_t y[9];
+    int nk = make_cases(x, y, r_ref, inpv[i], expv[i], outv[i]);
+    for (int k = 0; k < nk; ++k) {
+      uint64_t y_res[2];
+      int r_res = fixed_divide_tab[expv[i]](y_res, x[k].w);
+      if (y_res[0] != y[k].w[0] || y_res[1] != y[k].w[1] || r_res != r_ref[k]) {
+        fprintf(stderr, "Fixed: ");
+        report_failure(x[k], expv[i], y_res, r_res, y[k], r_ref[k]);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static void InitPow10Table(void)
+{
+  mp_uint128_t val(1);
+  for (unsigned i = 0; i < sizeof(pow10_tab)/sizeof(pow10_tab[0]); ++i) {
+    pow10_tab[i] = val;
     val *= 10;
   }
-}
\ No newline at end of file
+  for (unsigned i = 0; i < sizeof(pow10_wide_tab)/sizeof(pow10_wide_tab[0]); ++i)
+    pow10_wide_tab[i] = mulx(pow10_tab[i < 34 ? i : 34], pow10_tab[i < 34 ? 0 : i - 34]);
+}
+// dec32_test - check DivideDecimal32ByPowerOf10() around random quotients of up to 16 digits, n in range [0:16],
+// then compare its speed with DivideDecimal68ByPowerOf10() on zero-padded sources
+static bool dec32_test(int nInps, int nIter)
+{
+  std::mt19937_64 rndGen(32);
+  std::vector<mp_uint128_t> inpv(nInps);
+  std::vector<unsigned>     expv(nInps);
+  for (int i = 0; i < nInps; ++i) {
+    uint64_t w = rndGen();
+    unsigned n = unsigned(((w & 0xFFFFFFFF)*17) >> 32);
+    uint64_t q;
+    if (i % 2 == 1) // log-distributed on range [0:2**56-1]
+      q = rndGen() >> (8 + (w >> 32) % 56);
+    else            // uniform on range [0:10**16-1]
+      q = mulu(pow10_tab[16], mp_uint128_t(0, rndGen())).w[0];
+    const mp_uint128_t rem = mulu(pow10_tab[n], mp_uint128_t(0, rndGen()));
+    const mp_uint128_t minus1(uint64_t(-1), uint64_t(-1));
+    mp_uint128_t base = pow10_tab[n];
+    base *= q;
+    for (unsigned k = 0; k < 8; ++k) {
+      mp_uint128_t r;
+      switch (k) {
+        case 0: r = rem; break;
+        case 1: r = uint64_t(0); break;
+        case 2: r = uint64_t(1); break;
+        case 3: r = pow10_tab[n].half(); r += minus1; break;
+        case 4: r = pow10_tab[n].half(); break;
+        case 5: r = pow10_tab[n].half(); r += 1; break;
+        case 6: r = pow10_tab[n]; r += minus1; break;
+        default: // the largest quotient in valid range
+          q = (uint64_t(1) << 56) - 1;
+          base = pow10_tab[n];
+          base *= q;
+          r = pow10_tab[n];
+          r += minus1;
+          break;
+      }
+      if (n == 0)
+        r = uint64_t(0);
+      mp_uint128_t x = base;
+      x += r;
+      if (k == 0)
+        inpv[i] = x, expv[i] = n;
+      uint64_t y_res;
+      int r_res = DivideDecimal32ByPowerOf10(&y_res, x.w, n);
+      int r_ref = n == 0 ? 0 : calc_ret(r, pow10_tab[n]);
+      if (y_res != q || r_res != r_ref) {
+        report_words("",     x.w,    2); fprintf(stderr, " / 1E%u\n", n);
+        report_words("res: ", &y_res, 1); fprintf(stderr, ",%d\n", r_res);
+        report_words("ref: ", &q,     1); fprintf(stderr, ",%d\nFail!\n", r_ref);
+        return false;
+      }
+    }
+  }
+
+  std::vector<int64_t> tmVec(nIter);
+  int64_t tmMed[2];
+  uint64_t dummy = 0;
+  for (int fi = 0; fi < 2; ++fi) {
+    for (int it = 0; it < nIter; ++it) {
+      std::chrono::steady_clock::time_point hres_t0 = std::chrono::steady_clock::now();
+      if (fi == 0) {
+        for (int i = 0; i < nInps; ++i) {
+          uint64_t y;
+          int r = DivideDecimal32ByPowerOf10(&y, inpv[i].w, expv[i]);
+          dummy ^= y;
+          dummy ^= r;
+        }
+      } else {
+        for (int i = 0; i < nInps; ++i) {
+          const uint64_t x[4] = { inpv[i].w[0], inpv[i].w[1], 0, 0 };
+          uint64_t y[2];
+          int r = divide_fn(y, x, expv[i]);
+          dummy ^= y[0];
+          dummy ^= r;
+        }
+      }
+      std::chrono::steady_clock::time_point hres_t1 = std::chrono::steady_clock::now();
+      tmVec[it] = std::chrono::duration_cast<std::chrono::microseconds>(hres_t1 - hres_t0).count();
+    }
+    std::nth_element(tmVec.begin(), tmVec.begin()+(nIter/2), tmVec.end());
+    tmMed[fi] = tmVec[nIter/2];
+  }
+
+  printf("Dec32: rThr= %5.2f ns/call. Dec68 on the same inputs= %5.2f ns/call. Scale= 0 to 16.\n"
+    , tmMed[0]*1e3/nInps
+    , tmMed[1]*1e3/nInps
+    );
+
+  if (dummy==42)
+    printf("Blue moon\n");
+  return true;
+}
+
+// wide_test - check 68-digit instantiation of DivPow10Wide on the same cases as result_test()
+static bool wide_test(const mp_uint256_t* inpv, const unsigned* expv, const div_rem_t* outv, int nInps)
+{
+  for (int i = 0; i < nInps; ++i) {
+    int r_ref[9];
+    mp_uint256_t x[9];
+    mp_uint128_t y[9];
+    int nk = make_cases(x, y, r_ref, inpv[i], expv[i], outv[i]);
+    for (int k = 0; k < nk; ++k) {
+      uint64_t y_res[2];
+      int r_res = DivPow10Wide<4, 2, 34>::Divide(y_res, x[k].w, expv[i]);
+      if (y_res[0] != y[k].w[0] || y_res[1] != y[k].w[1] || r_res != r_ref[k]) {
+        report_failure(x[k], expv[i], y_res, r_res, y[k], r_ref[k]);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// x = x*10**n + a, 8 words, modulo 2**512
+static void mul_pow10_add_512(uint64_t x[8], unsigned n, uint64_t a)
+{
+  for (; n > 0; --n) {
+    uint64_t carry = 0;
+    for (int i = 0; i < 8; ++i) {
+      mp_uint128_t p(x[i]);
+      p *= 10;
+      p += carry;
+      x[i] = p.w[0];
+      carry = p.w[1];
+    }
+  }
+  for (int i = 0; i < 8 && a != 0; ++i) {
+    x[i] += a;
+    a = x[i] < a;
+  }
+}
+
+// dec144_test - check DivideDecimal144ByPowerOf10() against DivideDecimal144ByPowerOf10_ref(), n in range [0:72],
+// then compare their speed
+static bool dec144_test(int nInps, int nIter)
+{
+  std::mt19937_64 rndGen(144);
+  std::vector<uint64_t> inpv(nInps*8);
+  std::vector<unsigned> expv(nInps);
+  for (int i = 0; i < nInps; ++i) {
+    uint64_t w = rndGen();
+    unsigned n = unsigned(((w & 0xFFFFFFFF)*73) >> 32);
+    // random quotient below 2**239 > 10**72, log-distributed for odd i
+    uint64_t q[8] = { rndGen(), rndGen(), rndGen(), rndGen() >> 17 };
+    if (i % 2 == 1) {
+      unsigned nb = unsigned((w >> 32) % 239);
+      for (unsigned k = 0; k < 4; ++k)
+        q[k] = nb >= 64*k+64 ? q[k] : (nb > 64*k ? q[k] & ((uint64_t(1) << (nb - 64*k)) - 1) : 0);
+    }
+    // remainder: random below 10**n, or one of 0, 1, half-1, half, half+1, 10**n-1
+    uint64_t rem[8] = { 0 };
+    const unsigned rk = unsigned(rndGen() % 8);
+    if (n > 0 && rk >= 2) {
+      rem[0] = 1;
+      mul_pow10_add_512(rem, n, 0);
+      uint64_t h[8];
+      for (int k = 0; k < 8; ++k)
+        h[k] = (rem[k] >> 1) | (k < 7 ? rem[k+1] << 63 : 0);
+      switch (rk) {
+        case 2: memcpy(rem, h, sizeof(rem)); break;
+        case 3: memcpy(rem, h, sizeof(rem)); rem[0] += 1; break; // half is a multiple of 5, no carry
+        case 4: memcpy(rem, h, sizeof(rem)); rem[0] -= 1; break;
+        case 5: rem[0] -= 1; break;                               // 10**n is even, no borrow
+        default: { // random remainder = floor(random * 10**n / 2**256)
+          uint64_t r[8] = { rndGen(), rndGen(), rndGen(), rndGen() };
+          mul_pow10_add_512(r, n, 0);
+          memcpy(rem, &r[4], sizeof(uint64_t)*4);
+          memset(&rem[4], 0, sizeof(uint64_t)*4);
+          break;
+        }
+      }
+    } else if (rk == 1) {
+      rem[0] = n > 0;
+    }
+    uint64_t* x = &inpv[i*8];
+    memcpy(x, q, sizeof(q));
+    mul_pow10_add_512(x, n, 0);
+    uint64_t carry = 0;
+    for (int k = 0; k < 8; ++k) {
+      x[k] += carry;
+      carry = x[k] < carry;
+      x[k] += rem[k];
+      carry += x[k] < rem[k];
+    }
+    expv[i] = n;
+
+    uint64_t y_res[4], y_ref[4];
+    int r_res = DivideDecimal144ByPowerOf10(y_res, x, n);
+    int r_ref = DivideDecimal144ByPowerOf10_ref(y_ref, x, n);
+    if (memcmp(y_res, y_ref, sizeof(y_res)) != 0 || r_res != r_ref) {
+      report_words("",     x,     8); fprintf(stderr, " / 1E%u\n", n);
+      report_words("res: ", y_res, 4); fprintf(stderr, ",%d\n", r_res);
+      report_words("ref: ", y_ref, 4); fprintf(stderr, ",%d\nFail!\n", r_ref);
+      return false;
+    }
+  }
+
+  typedef int (*divide144_fn)(uint64_t result[4], const uint64_t src[8], unsigned n);
+  static const divide144_fn fn_tab[2] = { DivideDecimal144ByPowerOf10, DivideDecimal144ByPowerOf10_ref };
+  std::vector<int64_t> tmVec(nIter);
+  int64_t tmMed[2];
+  uint64_t dummy = 0;
+  for (int fi = 0; fi < 2; ++fi) {
+    divide144_fn fn = fn_tab[fi];
+    for (int it = 0; it < nIter; ++it) {
+      std::chrono::steady_clock::time_point hres_t0 = std::chrono::steady_clock::now();
+      for (int i = 0; i < nInps; ++i) {
+        uint64_t y[4];
+        int r = fn(y, &inpv[i*8], expv[i]);
+        dummy ^= y[0];
+        dummy ^= y[3];
+        dummy ^= r;
+      }
+      std::chrono::steady_clock::time_point hres_t1 = std::chrono::steady_clock::now();
+      tmVec[it] = std::chrono::duration_cast<std::chrono::microseconds>(hres_t1 - hres_t0).count();
+    }
+    std::nth_element(tmVec.begin(), tmVec.begin()+(nIter/2), tmVec.end());
+    tmMed[fi] = tmVec[nIter/2];
+  }
+
+  printf("Dec144: rThr= %5.2f ns/call. reference long division= %7.2f ns/call. Scale= 0 to 72.\n"
+    , tmMed[0]*1e3/nInps
+    , tmMed[1]*1e3/nInps
+    );
+
+  if (dummy==42)
+    printf("Blue moon\n");
+  return true;
+}
@@ -0,0 +1,242 @@
+# test vectors for bid128_test.cpp, expected results computed by Python decimal module
+# usage: python3 mk_bid128_tests.py > bid128_test_vectors.h
+import decimal
+import random
+from decimal import Decimal
+
+M64 = 2**64 - 1
+BIAS = 6176
+EXP_MAX = 12287
+
+ROUNDING = [ # in order of BID_ROUND_xxx
+  decimal.ROUND_HALF_EVEN, decimal.ROUND_FLOOR, decimal.ROUND_CEILING, decimal.ROUND_DOWN, decimal.ROUND_HALF_UP ]
+
+FLAGS = [
+  (decimal.InvalidOperation, 0x01),
+  (decimal.Overflow,         0x08),
+  (decimal.Underflow,        0x10),
+  (decimal.Inexact,          0x20),
+]
+
+def make_ctx(rnd_mode):
+  ctx = decimal.Context(prec=34, Emax=6144, Emin=-6143, clamp=1, rounding=ROUNDING[rnd_mode], traps=[])
+  return ctx
+
+# encode Decimal as BID128, returns (w0, w1)
+def encode(d):
+  sign, digits, exp = d.as_tuple()
+  hi = sign << 63
+  if exp == 'F':
+    return (0, hi | (0x1E << 58))
+  if exp in ('n', 'N'):
+    payload = int(''.join(map(str, digits))) if digits else 0
+    hi |= (0x3F if exp == 'N' else 0x3E) << 57
+    return (payload & M64, hi | (payload >> 64))
+  coef = int(''.join(map(str, digits)))
+  hi |= ((exp + BIAS) << 49) | (coef >> 64)
+  return (coef & M64, hi)
+
+# decode BID128 as Decimal, non-canonical coefficients are zeros
+def decode(w):
+  w0, w1 = w
+  sign = w1 >> 63
+  if (w1 >> 59 & 15) == 15:
+    if (w1 >> 58 & 1) == 0:
+      return Decimal((sign, (0,), 'F'))
+    payload = ((w1 & (2**46-1)) << 64) | w0
+    if payload >= 10**33:
+      payload = 0
+    return Decimal((sign, tuple(map(int, str(payload))), 'N' if (w1 >> 57 & 1) else 'n'))
+  if (w1 >> 61 & 3) == 3:
+    exp = w1 >> 47 & 0x3FFF
+    coef = 0
+  else:
+    exp = w1 >> 49 & 0x3FFF
+    coef = ((w1 & (2**49-1)) << 64) | w0
+    if coef >= 10**34:
+      coef = 0
+  return Decimal((sign, tuple(map(int, str(coef))), exp - BIAS))
+
+def rnd_finite(rng):
+  nd = rng.choice([1, 2, 17, 33, 34, rng.randint(1, 34)])
+  coef = rng.randrange(10**(nd-1) if nd > 1 else 0, 10**nd)
+  if rng.random() < 0.1:
+    coef = rng.choice([10**(nd-1), 10**nd-1, 5*10**(nd-1)])
+  exp = rng.choice([rng.randint(0, EXP_MAX), rng.randint(BIAS-40, BIAS+40),
+                    rng.randint(0, 40), rng.randint(EXP_MAX-40, EXP_MAX),
+                    rng.randint(BIAS//2-40, BIAS//2+40), rng.randint(BIAS*3//2-40, BIAS*3//2+40)])
+  return (coef & M64, (rng.getrandbits(1) << 63) | (exp << 49) | (coef >> 64))
+
+SPECIALS = [
+  (0, 0x3040000000000000),          # +0
+  (0, 0xB040000000000000),          # -0
+  (1, 0x3040000000000000),          # 1
+  (0, 0x7800000000000000),          # +Inf
+  (0, 0xF800000000000000),          # -Inf
+  (0, 0x7C00000000000000),          # qNaN
+  (123, 0xFC00000000000000),        # -qNaN with payload
+  (7, 0x7E00000000000000),          # sNaN with payload
+  (M64, 0x7C003FFFFFFFFFFF),        # qNaN, non-canonical payload
+  (M64, 0x3041FFFFFFFFFFFF),        # non-canonical coefficient >= 10**34
+  (5, 0x6FFF000000000000),          # non-canonical, coefficient >= 2**113
+  (0x378D8E63FFFFFFFF, 0x5FFFED09BEAD87C0), # max finite
+  (1, 0x0000000000000000),          # min subnormal
+]
+
+def nan_result(ops):
+  # NaN operand propagation of bid128.c: the first NaN operand, quieted
+  dec = [decode(x) for x in ops]
+  flags = 0x01 if any(d.is_snan() for d in dec) else 0
+  d = [d for d in dec if d.is_nan()][0]
+  w0, w1 = encode(d)
+  return (w0, w1 & ~(1 << 57)), flags
+
+def reference(op, ops, rnd_mode):
+  dec = [decode(x) for x in ops]
+  if any(d.is_nan() for d in dec):
+    return nan_result(ops)
+  ctx = make_ctx(rnd_mode)
+  res = op(ctx, *dec)
+  flags = 0
+  for cond, f in FLAGS:
+    if ctx.flags[cond]:
+      flags |= f
+  if res.is_nan():
+    res = Decimal('NaN')
+  return encode(res), flags
+
+def print_vectors(name, cases, op):
+  print("static const bid128_test_vector_t %s[] = {" % name)
+  for ops in cases:
+    x, y = ops[0], ops[1]
+    z = ops[2] if len(ops) > 2 else (0, 0)
+    res = [reference(op, ops, rnd_mode) for rnd_mode in range(5)]
+    print(" {{0x%016x,0x%016x},{0x%016x,0x%016x},{0x%016x,0x%016x},{%s},{%s}}," % (
+      x[0], x[1], y[0], y[1], z[0], z[1],
+      ",".join("{0x%016x,0x%016x}" % r for r, f in res), ",".join("0x%02x" % f for r, f in res)))
+  print("};")
+
+def gen_binary(name, op, rng, nrand):
+  cases = [(x, y) for x in SPECIALS for y in SPECIALS]
+  for i in range(nrand):
+    x = rnd_finite(rng)
+    y = rnd_finite(rng) if rng.random() < 0.9 else rng.choice(SPECIALS)
+    cases.append((x, y) if rng.random() < 0.5 else (y, x))
+  print_vectors(name, cases, op)
+
+# finite operand with exponent close to exp
+def rnd_near(rng, exp, nd=None):
+  nd = nd or rng.randint(1, 34)
+  coef = rng.randrange(10**(nd-1) if nd > 1 else 0, 10**nd)
+  exp = min(max(exp, 0), EXP_MAX)
+  return (coef & M64, (rng.getrandbits(1) << 63) | (exp << 49) | (coef >> 64))
+
+def get_exp(x):
+  return x[1] >> 49 & 0x3FFF
+
+def gen_fma(name, rng, nrand):
+  cases = [(x, y, z) for x in SPECIALS[::3] for y in SPECIALS[::3] for z in SPECIALS[::3]]
+  for i in range(nrand):
+    x = rnd_finite(rng)
+    y = rnd_finite(rng)
+    ep = get_exp(x) + get_exp(y) - BIAS
+    kind = rng.randint(0, 3)
+    if kind == 0:   # independent
+      z = rnd_finite(rng)
+    elif kind == 1: # exponents near the product
+      z = rnd_near(rng, ep + rng.randint(-70, 70))
+    elif kind == 2: # massive cancellation, z = -x*y rounded to 34 digits
+      ctx = make_ctx(rng.randint(0, 4))
+      p = ctx.multiply(decode(x), decode(y))
+      z = encode(ctx.minus(p)) if p.is_finite() else rnd_finite(rng)
+    else:           # z far away
+      z = rnd_near(rng, ep + rng.choice([-1, 1])*rng.randint(70, 200))
+    cases.append((x, y, z))
+  print_vectors(name, cases, lambda ctx, a, b, c: ctx.fma(a, b, c))
+
+def gen_add(name, rng, nrand, sub=False):
+  cases = [(x, y) for x in SPECIALS for y in SPECIALS]
+  for i in range(nrand):
+    x = rnd_finite(rng)
+    kind = rng.randint(0, 3)
+    if kind == 0:
+      y = rnd_finite(rng)
+    elif kind == 1:
+      y = rnd_near(rng, get_exp(x) + rng.randint(-40, 40))
+    elif kind == 2: # cancellation
+      d = decode(x)
+      ctx = make_ctx(0)
+      y = ctx.add(d, Decimal((0, (rng.randint(0, 9),), d.as_tuple().exponent + rng.randint(-3, 3))))
+      y = y if sub else ctx.minus(y)
+      y = encode(y) if y.is_finite() else rnd_finite(rng)
+    else:
+      y = rnd_near(rng, get_exp(x) + rng.choice([-1, 1])*rng.randint(30, 80))
+    cases.append((x, y))
+  print_vectors(name, cases, (lambda ctx, a, b: ctx.subtract(a, b)) if sub else (lambda ctx, a, b: ctx.add(a, b)))
+
+rng = random.Random(1)
+print("// generated by mk_bid128_tests.py, do not edit")
+print("struct bid128_test_vector_t {\n  uint64_t x[2], y[2], z[2];\n  uint64_t res[5][2]; // for each of BID_ROUND_xxx\n  unsigned flags[5];\n};")
+gen_binary("bid128_mul_vectors", lambda ctx, a, b: ctx.multiply(a, b), rng, 400)
+gen_fma("bid128_fma_vectors", rng, 600)
+gen_add("bid128_add_vectors", rng, 300)
+gen_add("bid128_sub_vectors", rng, 300, sub=True)
+
+def gen_str(name, rng, nrand):
+  cases = list(SPECIALS)
+  for i in range(nrand):
+    x = rnd_finite(rng) if rng.random() < 0.5 else rnd_near(rng, BIAS + rng.randint(-45, 10))
+    cases.append(x)
+  print("static const bid128_str_vector_t %s[] = {" % name)
+  for x in cases:
+    print(" {{0x%016x,0x%016x},\"%s\"}," % (x[0], x[1], str(decode(x))))
+  print("};")
+
+print("struct bid128_str_vector_t {\n  uint64_t x[2];\n  const char* str;\n};")
+gen_str("bid128_str_vectors", rng, 1000)
+
+def rnd_numeric_string(rng):
+  kind = rng.randint(0, 4)
+  if kind == 0: # output of to-scientific-string
+    return str(decode(rnd_finite(rng)))
+  if kind == 1: # ties and near-ties beyond 34 digits
+    s = str(rng.randrange(10**33, 10**34)) + rng.choice(['5', '50', '5000000000000000000000000000000000001', '4999', '51', '0'*40 + '1'])
+  else: # random length
+    nd = rng.choice([rng.randint(1, 20), rng.randint(30, 40), rng.randint(60, 75), rng.randint(1, 120)])
+    s = ''.join(rng.choice('0123456789') for i in range(nd))
+    if rng.random() < 0.3:
+      s = '0' * rng.randint(1, 12) + s
+  if rng.random() < 0.6:
+    p = rng.randint(0, len(s))
+    s = s[:p] + '.' + s[p:]
+  if rng.random() < 0.5:
+    s += rng.choice('eE') + rng.choice(['', '+', '-']) + str(rng.choice([rng.randint(0, 50), rng.randint(0, 7000), rng.randint(6000, 6300)]))
+  return rng.choice(['', '', '+', '-']) + s
+
+PARSE_SPECIALS = [
+  '0', '-0', '0.000', '0E+7000', '-0E-7000', '1', '.5', '5.', '-.0', '1E+6144', '1E+6111', '1E-6176', '1E-6177', '5E-6177',
+  '9999999999999999999999999999999999E+6111', '99999999999999999999999999999999995E+6110',
+  'Inf', '-Infinity', 'iNfInItY', 'NaN', 'nan', '-NaN123', 'NaN00045', 'sNaN', '-snan7',
+  'NaN' + '1' * 33, 'NaN' + '1' * 34, '', '.', '-', '+.', 'abc', 'E5', 'in', 'infinit',
+  '1' * 68 + '5', '1' * 68 + '0' * 30 + '1', '0.' + '0' * 50 + '1' * 70, '1' * 200 + 'E-100',
+]
+
+def gen_parse(name, rng, nrand):
+  cases = PARSE_SPECIALS + [rnd_numeric_string(rng) for i in range(nrand)]
+  print("static const bid128_parse_vector_t %s[] = {" % name)
+  for s in cases:
+    res = []
+    for rnd_mode in range(5):
+      ctx = make_ctx(rnd_mode)
+      d = ctx.create_decimal(s)
+      flags = 0
+      for cond, f in FLAGS:
+        if ctx.flags[cond]:
+          flags |= f
+      res.append((encode(d), flags))
+    print(" {\"%s\",{%s},{%s}}," % (s,
+      ",".join("{0x%016x,0x%016x}" % r for r, f in res), ",".join("0x%02x" % f for r, f in res)))
+  print("};")
+
+print("struct bid128_parse_vector_t {\n  const char* str;\n  uint64_t res[5][2]; // for each of BID_ROUND_xxx\n  unsigned flags[5];\n};")
+gen_parse("bid128_parse_vectors", rng, 1000)
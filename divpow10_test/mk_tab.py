@@ -1,4 +1,7 @@
 import math
+# divpow10_recip_tab rows, then divpow10_mulF_h_tab
+rows = []
+mulF_h = []
 for n in range(1, 35):
   nbits = math.log2(10)*(n+34)
   nbytes = math.ceil(nbits/8)
@@ -19,7 +22,12 @@ for n in range(1, 35):
   p101 = p10 // 2**64
   p100 = p10 - p101 * 2**64
   src_offsLL = 24 if offs==0 else (0 if offs < 4 else offs - 4)
-  steaky_msk = 256**rem_offs - 1
   shift_LL = (4-offs)*8 if offs > 0 and offs < 4 else 0
-  print(" {%2d, %2d, %d, %2d, 0x%08x, 0x%016x, 0x%016x, 0x%016x, 0x%08x }, // %2d" % (offs, src_offsLL, rem_offs, shift_LL, div20, div21, div22, p100, steaky_msk, n))
+  rows.append(" {%2d, %2d, %d, %2d, 0x%08x, 0x%016x, 0x%016x, 0x%016x }, // %2d" % (offs, src_offsLL, rem_offs, shift_LL, div20, div21, div22, p100, n))
+  mulF_h.append(p101)
+
+print("\n".join(rows))
+print("")
+for i in range(0, 34, 8):
+  print("  " + " ".join("0x%05x," % v for v in mulF_h[i:i+8]))
 
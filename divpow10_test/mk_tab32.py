@@ -0,0 +1,13 @@
+# reciprocal table for divide_pow10_32.c
+# src is pre-shifted by n-1, that removes factor 2**(n-1) of divisor 10**n/2, so x = src >> (n-1) is divided by 5**n
+# q = floor(floor(x / 2**s) * M / 2**(64+k)) underestimates floor(x / 5**n) by at most 1
+# for x < 5**n * 2**57, i.e. for src < 10**n * 2**56
+# columns: M, 5**n, n-1+s, k
+for n in range(1, 17):
+  D = 5**n
+  e = D.bit_length() - 1          # 2**e <= D < 2**(e+1)
+  M = 2**(64+e) // D              # 2**63 <= M < 2**64
+  s = max(0, (D * 2**57 - 1).bit_length() - 64) # x >> s fits into 64 bits
+  k = e - s
+  assert 2**63 <= M < 2**64 and 0 <= k < 64 and (s == 0 or 2**s * 64 <= D)
+  print(" { 0x%016x, 0x%010x, %2d, %d }, // %2d" % (M, D, n-1+s, k, n))
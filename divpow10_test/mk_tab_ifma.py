@@ -0,0 +1,12 @@
+# reciprocal table for divide_pow10_ifma.c
+# Q = floor(floor(src / 2**s) * R / 2**114) underestimates floor(src/10**n) by at most 2
+# for src < 10**n * 2**113
+M52 = 2**52 - 1
+print(" { 0, { 0, 0, 0 }, { 0, 0, 0 }, 0 }, //  0")
+for n in range(1, 35):
+  D = 10**n
+  s = D.bit_length() - 1
+  R = 2**(s+114) // D
+  assert R < 2**114
+  print(" {%3d, { 0x%013x, 0x%013x, 0x%03x }, { 0x%013x, 0x%013x, 0x%03x }, 0 }, // %2d" % (
+    s, R & M52, (R >> 52) & M52, R >> 104, D & M52, (D >> 52) & M52, D >> 104, n))
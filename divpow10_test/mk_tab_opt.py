@@ -0,0 +1,122 @@
+from fractions import Fraction
+from itertools import product
+import math
+import sys
+# recip_tab rows and mul_count_tab of divide_pow10_opt.c, per-n report to stderr
+#
+# Division by 10**n/2 = 5**n * 2**t, t = n-1: x = src >> t, r = floor(x / 5**n) = 2*quotient + upper half bit.
+# Estimate r_est = floor(y * m / 2**(k-s)), y = x >> s, the window of x, m = floor(2**k / 5**n).
+# y and m are 2 words each, the product is y_h*m_h + high words of y_h*m_l and y_l*m_h,
+# low words of the cross products and y_l*m_l are dropped, i.e. the kernel does 3 multiplications.
+# x - r_est*5**n is in [0, 2*5**n), when the total error of the estimate is below 1:
+#   (2**s-1)/5**n                    - bits of x below the window
+#   x_max*(2**k - m*5**n)/(5**n*2**k) - truncation of the reciprocal
+#   3*2**128/2**(k-s)                - dropped partial products
+# over the whole range of results the other variants support, quotient < 10**34 (above the documented 2**112),
+# i.e. x <= x_max = 5**n * 2*10**34 - 1.
+# One correction step fixes r_est, it needs the low REM_WORDS words of x - r_est*5**n:
+# 1 word (1 multiplication) while 2*5**n < 2**64, otherwise 2 words (3 multiplications).
+#
+# Multiplication count. For every n the script searches all estimates of the same kind, a truncated schoolbook
+# product of 64-bit words: window y of 1 or 2 words at any bit position s, reciprocal m of 1 or 2 words for any k,
+# and every partial product y_i*m_j either kept in full, kept as its high word only, or dropped. mul_count_tab[]
+# is the fewest multiplications among the provable ones, plus the multiplications of the low words of r*5**n.
+# So the count is minimal within this family only. Other schemes, e.g. a 3-word reciprocal with a shorter
+# correction, or a reciprocal in floating point, are not searched.
+
+WORD = 2**64
+
+def bound(n, s, k):
+  d = 5**n
+  x_max = d * 2*10**34 - 1
+  m = 2**k // d
+  return Fraction(2**s - 1, d) + Fraction(x_max * (2**k - m*d), d * 2**k) + Fraction(3 * 2**128, 2**(k-s))
+
+def words(v):
+  return max(1, (v.bit_length() + 63) // 64)
+
+# min_estimate_muls - fewest partial products of a provable estimate of floor(x / 5**n), with the first
+# window, reciprocal and pattern found for that count
+# pattern has one letter per y_i*m_j, in order y_0*m_0, y_0*m_1, ..., y_1*m_0, ...:
+# 'F' - full product, 'H' - high word only, '-' - dropped
+def min_estimate_muls(n):
+  d = 5**n
+  x_max = d * 2*10**34 - 1
+  best = None
+  for wy, wm in product((1, 2), (1, 2)):
+    pairs = [(i, j) for i in range(wy) for j in range(wm)]
+    # patterns ordered by the number of kept products
+    pats = sorted(product("-HF", repeat=len(pairs)), key=lambda p: len(p) - p.count("-"))
+    for s in range(max(0, x_max.bit_length() - 64*wy), d.bit_length()):
+      y_max = x_max >> s
+      ys = [min(WORD - 1, y_max >> 64*i) for i in range(wy)]
+      for k in range(s + 1, s + 64*wm + d.bit_length() + 1):
+        m = 2**k // d
+        if m >= WORD**wm:
+          break
+        ms = [(m >> 64*j) % WORD for j in range(wm)]
+        # error below 1 <=> window + truncation + products < d * 2**k, all scaled by d * 2**k
+        base = (2**s - 1) * 2**k + x_max * (2**k - m*d)
+        if base >= d * 2**k:
+          continue
+        for pat in pats:
+          cnt = len(pat) - pat.count("-")
+          if best and cnt >= best[0]:
+            break
+          err = 0 # error of the product, upper bound
+          for (i, j), op in zip(pairs, pat):
+            if op == "H":
+              err += WORD**(i+j+1)
+            elif op == "-":
+              err += ys[i] * ms[j] * WORD**(i+j)
+          if base + err * d * 2**s < d * 2**k:
+            best = (cnt, wy, wm, s, k, "".join(pat))
+            break
+  return best
+
+# rem_muls - multiplications of the low words of r*5**n, r < 2**128, as many words as 2*5**n has
+def rem_muls(n):
+  d = 5**n
+  w = words(2*d)
+  return sum(1 for i in range(2) for j in range(words(d)) if i + j < w)
+
+rows = []
+counts = []
+for n in range(1, 35):
+  d = 5**n
+  t = n - 1
+  x_max = d * 2*10**34 - 1
+  s_min = max(0, x_max.bit_length() - 128)  # y < 2**128
+  # narrowest provable reciprocal and window
+  cands = []
+  for s in range(s_min, d.bit_length()):
+    for k in range(s + 128, s + 192):
+      if 2**k // d >= 2**128:
+        break
+      if bound(n, s, k) < 1:
+        cands.append((s, k))
+  assert cands, n
+  m_bits_min = min((2**k // d).bit_length() for s, k in cands)
+  y_bits_min = min(x_max.bit_length() - s for s, k in cands)
+  # emit candidate with maximal slack, m normalized to 128 bits
+  s, k = min(cands, key=lambda c: bound(n, c[0], c[1]))
+  m = 2**k // d
+  e = bound(n, s, k)
+  p = t + s            # window position in src
+  c = k - s - 128      # shift of the high 128 bits of the product
+  est = min_estimate_muls(n)
+  assert est and est[0] == 3, (n, est) # the kernel does 3, -HHF
+  muls = est[0] + rem_muls(n)
+  assert muls == 3 + (1 if 2*d < 2**64 else 3)
+  counts.append(muls)
+  assert p < 128 and c < 64 and (d >> 64) < 2**48
+  rows.append("   {0x%016X, 0x%016X, 0x%016X, 0x%016X }, // %2d" % (
+    m % 2**64, m >> 64, d % 2**64, (d >> 64) | p << 48 | c << 56, n))
+  sys.stderr.write("n=%2d: reciprocal %3d bits (min %3d), window %3d bits (min %3d) at src bit %3d, error < 2**%.1f, "
+    "%d multiplications (min for estimate %d, remainder %d)\n" % (
+    n, m.bit_length(), m_bits_min, x_max.bit_length() - s, y_bits_min, p, math.log2(e), muls, est[0], rem_muls(n)))
+
+print("\n".join(rows))
+print("")
+for i in range(0, 34, 17):
+  print("  " + " ".join("%d," % v for v in counts[i:i+17]))
@@ -0,0 +1,14 @@
+# tables of RoundDecimal68ToDigits in divide_pow10_round.c, divpow10_pow10_tab is shared with bid128.c
+M64 = 2**64 - 1
+# digits_of_bits[b] - number of decimal digits of 2**(b-1), i.e. the smaller of the two digit counts of b-bit numbers,
+# clamped to 68, so out-of-contract sources don't index beyond divpow10_pow10_tab
+row = []
+for b in range(0, 257):
+  row.append(min(len(str(2**(b-1))) if b > 0 else 1, 68))
+for i in range(0, 257, 32):
+  print("  " + "".join("%2d," % v for v in row[i:i+32]))
+print()
+# divpow10_pow10_tab - powers of ten, 4 64-bit words, Little Endian
+for n in range(0, 69):
+  p = 10**n
+  print(" { 0x%016x, 0x%016x, 0x%016x, 0x%016x }, // %2d" % (p & M64, (p >> 64) & M64, (p >> 128) & M64, p >> 192, n))
@@ -0,0 +1,133 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// PerfCounters - hardware performance counters of the calling thread, counted as one group
+//
+// Comments:
+// 1. Uses perf_event_open, so it works only on Linux. Elsewhere, or when the kernel refuses to open
+//    the counters (perf_event_paranoid, virtual machines without PMU), Available() returns false,
+//    Error() tells why and all counts are reported as -1.
+// 2. Fixed events are cycles, instructions and branch mispredictions. Up to MAX_RAW model-specific
+//    events (PERF_TYPE_RAW config, e.g. uops dispatched to a port) can be added, those that fail to open
+//    are reported as -1 without disabling the rest.
+// 3. Start()/Stop() pairs accumulate, counts are scaled when the kernel multiplexes the group.
+class PerfCounters {
+public:
+  enum { CYCLES, INSTRUCTIONS, BRANCH_MISSES, N_FIXED, MAX_RAW = 4, MAX_EVENTS = N_FIXED + MAX_RAW };
+
+  PerfCounters() : m_nEvents(0), m_err("not opened") {
+    for (int i = 0; i < MAX_EVENTS; ++i) {
+      m_fd[i] = -1;
+      m_acc[i] = 0;
+    }
+  }
+  ~PerfCounters() { Close(); }
+
+  bool Open(const uint64_t* raw = 0, int nRaw = 0) {
+    Close();
+#if defined(__linux__)
+    static const uint64_t fixed_cfg[N_FIXED] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES };
+    m_nEvents = N_FIXED + (nRaw < MAX_RAW ? nRaw : MAX_RAW);
+    for (int i = 0; i < m_nEvents; ++i) {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size   = sizeof(attr);
+      attr.type   = i < N_FIXED ? PERF_TYPE_HARDWARE : PERF_TYPE_RAW;
+      attr.config = i < N_FIXED ? fixed_cfg[i] : raw[i - N_FIXED];
+      attr.disabled       = i == 0; // members follow the leader
+      attr.exclude_kernel = 1;
+      attr.exclude_hv     = 1;
+      attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      m_fd[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : m_fd[0], 0);
+      if (m_fd[i] < 0) {
+        if (i == 0) {
+          m_err = strerror(errno);
+          m_nEvents = 0;
+          return false;
+        }
+        continue;
+      }
+      uint64_t id = 0;
+      ioctl(m_fd[i], PERF_EVENT_IOC_ID, &id);
+      m_id[i] = id;
+    }
+    m_err = 0;
+    return true;
+#else
+    (void)raw; (void)nRaw;
+    m_err = "perf_event_open is available only on Linux";
+    return false;
+#endif
+  }
+
+  void Close() {
+#if defined(__linux__)
+    for (int i = 0; i < MAX_EVENTS; ++i) {
+      if (m_fd[i] >= 0)
+        close(m_fd[i]);
+      m_fd[i] = -1;
+    }
+#endif
+    m_nEvents = 0;
+  }
+
+  bool        Available() const { return m_nEvents > 0; }
+  const char* Error()     const { return m_err ? m_err : ""; }
+  int         NumEvents() const { return m_nEvents; }
+
+  void Reset() {
+    for (int i = 0; i < MAX_EVENTS; ++i)
+      m_acc[i] = 0;
+  }
+
+  void Start() {
+#if defined(__linux__)
+    if (!Available())
+      return;
+    ioctl(m_fd[0], PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP);
+    ioctl(m_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+
+  void Stop() {
+#if defined(__linux__)
+    if (!Available())
+      return;
+    ioctl(m_fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    uint64_t buf[3 + MAX_EVENTS*2]; // nr, time_enabled, time_running, {value, id}[nr]
+    if (read(m_fd[0], buf, sizeof(buf)) < (ssize_t)(3*sizeof(uint64_t)))
+      return;
+    const uint64_t nr = buf[0] < MAX_EVENTS ? buf[0] : MAX_EVENTS;
+    const double scale = buf[2] != 0 ? double(buf[1]) / double(buf[2]) : 0;
+    for (uint64_t k = 0; k < nr; ++k) {
+      for (int i = 0; i < m_nEvents; ++i) {
+        if (m_fd[i] >= 0 && m_id[i] == buf[3 + k*2 + 1])
+          m_acc[i] += double(buf[3 + k*2]) * scale;
+      }
+    }
+#endif
+  }
+
+  // PerCall - accumulated count of event i divided by nCalls, -1 when the event is not available
+  double PerCall(int i, double nCalls) const {
+    if (i >= m_nEvents || m_fd[i] < 0 || nCalls <= 0)
+      return -1;
+    return m_acc[i] / nCalls;
+  }
+
+private:
+  int         m_fd[MAX_EVENTS];
+  uint64_t    m_id[MAX_EVENTS];
+  double      m_acc[MAX_EVENTS];
+  int         m_nEvents;
+  const char* m_err;
+};